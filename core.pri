@@ -0,0 +1,6 @@
+win32 {
+    CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/debug -lFramelessHelperCored
+    else: CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/release -lFramelessHelperCore
+} else: unix {
+    LIBS += -L$$OUT_PWD/bin -lFramelessHelperCore
+}
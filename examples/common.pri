@@ -14,9 +14,13 @@ win32 {
     RC_FILE = $$PWD/example.rc
     OTHER_FILES += $$PWD/example.manifest
 }
-win32 {
-    CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../debug -lFramelessHelperd
-    else: CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../release -lFramelessHelper
-} else: unix {
-    LIBS += -L$$OUT_PWD/../../bin -lFramelessHelper
+FRAMELESSHELPER_LIBS += FramelessHelperCore
+for(lib, FRAMELESSHELPER_LIBS) {
+    win32 {
+        CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../debug -l$${lib}d
+        else: CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../release -l$${lib}
+    } else: unix {
+        LIBS += -L$$OUT_PWD/../../bin -l$${lib}
+    }
 }
+framelesshelper_static: DEFINES += FRAMELESSHELPER_STATIC
@@ -23,9 +23,8 @@
  */
 
 #include "mainwindow.h"
-#include <QtGui/qpainter.h>
 #include "../../framelesswindowsmanager.h"
-#include "../../utilities.h"
+#include "../../framelesswindowborderoverlay.h"
 
 FRAMELESSHELPER_USE_NAMESPACE
 
@@ -65,6 +64,8 @@ MainWindow::MainWindow(QWidget *parent, Qt::WindowFlags flags) : QMainWindow(par
     });
 
     setWindowTitle(tr("Hello, World!"));
+
+    new WindowBorderOverlay(this);
 }
 
 MainWindow::~MainWindow()
@@ -101,49 +102,12 @@ void MainWindow::showEvent(QShowEvent *event)
 void MainWindow::changeEvent(QEvent *event)
 {
     QWidget::changeEvent(event);
-    bool shouldUpdate = false;
     if (event->type() == QEvent::WindowStateChange) {
         if (isMaximized() || isFullScreen()) {
             setContentsMargins(0, 0, 0, 0);
         } else if (!isMinimized()) {
             setContentsMargins(1, 1, 1, 1);
         }
-        shouldUpdate = true;
         Q_EMIT windowStateChanged();
-    } else if (event->type() == QEvent::ActivationChange) {
-        shouldUpdate = true;
-    }
-    if (shouldUpdate) {
-        update();
-    }
-}
-
-void MainWindow::paintEvent(QPaintEvent *event)
-{
-    QMainWindow::paintEvent(event);
-    if (windowState() == Qt::WindowNoState) {
-        QPainter painter(this);
-        const int w = width();
-        const int h = height();
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        using BorderLines = QList<QLine>;
-#else
-        using BorderLines = QVector<QLine>;
-#endif
-        const BorderLines lines = {
-            {0, 0, w, 0},
-            {w - 1, 0, w - 1, h},
-            {w, h - 1, 0, h - 1},
-            {0, h, 0, 0}
-        };
-        painter.save();
-        const ColorizationArea area = Utilities::getColorizationArea();
-        const bool colorizedBorder = ((area == ColorizationArea::TitleBar_WindowBorder)
-                                      || (area == ColorizationArea::All));
-        const QColor borderColor = (isActiveWindow() ? (colorizedBorder ? Utilities::getColorizationColor() : Qt::black) : Qt::darkGray);
-        const auto borderThickness = static_cast<qreal>(Utilities::getWindowVisibleFrameBorderThickness(winId()));
-        painter.setPen({borderColor, borderThickness});
-        painter.drawLines(lines);
-        painter.restore();
     }
 }
@@ -4,4 +4,5 @@ QT += widgets
 HEADERS += mainwindow.h
 SOURCES += mainwindow.cpp main.cpp
 FORMS += TitleBar.ui MainWindow.ui
+FRAMELESSHELPER_LIBS += FramelessHelperWidgets
 include($$PWD/../common.pri)
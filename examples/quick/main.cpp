@@ -23,10 +23,16 @@
  */
 
 #include "../../framelessquickhelper.h"
+#include "../../framelessquicktitlebar.h"
 #include <QtGui/qguiapplication.h>
 #include <QtQml/qqmlapplicationengine.h>
 #include <QtQuickControls2/qquickstyle.h>
 
+#ifdef FRAMELESSHELPER_QML_STATIC_PLUGIN
+#include <QtQml/qqmlextensionplugin.h>
+Q_IMPORT_QML_PLUGIN(wangwenx190_UtilsPlugin)
+#endif
+
 int main(int argc, char *argv[])
 {
     QCoreApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
@@ -48,7 +54,13 @@ int main(int argc, char *argv[])
     QQuickStyle::setStyle(QStringLiteral("Default"));
 #endif
 
+#if defined(FRAMELESSHELPER_QML_IMPORT_PATH)
+    // The types are registered by the QML module plugin once it gets loaded.
+    engine.addImportPath(QStringLiteral(FRAMELESSHELPER_QML_IMPORT_PATH));
+#elif !defined(FRAMELESSHELPER_QML_STATIC_PLUGIN)
     qmlRegisterType<FRAMELESSHELPER_PREPEND_NAMESPACE(FramelessQuickHelper)>("wangwenx190.Utils", 1, 0, "FramelessHelper");
+    qmlRegisterType<FRAMELESSHELPER_PREPEND_NAMESPACE(FramelessQuickTitleBar)>("wangwenx190.Utils", 1, 0, "FramelessTitleBar");
+#endif
 
     const QUrl mainQmlUrl(QStringLiteral("qrc:///qml/main.qml"));
     const QMetaObject::Connection connection = QObject::connect(
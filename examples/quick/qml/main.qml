@@ -40,6 +40,7 @@ Window {
 
     FramelessHelper {
         id: framelessHelper
+        hitTestVisibleItems: [minimizeButton, maximizeButton, closeButton]
     }
 
     Timer {
@@ -80,7 +81,6 @@ Window {
             MinimizeButton {
                 id: minimizeButton
                 onClicked: window.showMinimized()
-                Component.onCompleted: framelessHelper.setHitTestVisible(minimizeButton, true)
             }
 
             MaximizeButton {
@@ -93,13 +93,11 @@ Window {
                         window.showMaximized()
                     }
                 }
-                Component.onCompleted: framelessHelper.setHitTestVisible(maximizeButton, true)
             }
 
             CloseButton {
                 id: closeButton
                 onClicked: window.close()
-                Component.onCompleted: framelessHelper.setHitTestVisible(closeButton, true)
             }
         }
     }
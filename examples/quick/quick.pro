@@ -4,4 +4,5 @@ QT += quick quickcontrols2
 CONFIG(release, debug|release): CONFIG += qtquickcompiler
 SOURCES += main.cpp
 RESOURCES += qml.qrc
+FRAMELESSHELPER_LIBS += FramelessHelperQuick
 include($$PWD/../common.pri)
@@ -23,6 +23,7 @@
  */
 
 #include <QtWidgets/qapplication.h>
+#include "../../framelesshelperwidgets.h"
 #include "widget.h"
 
 int main(int argc, char *argv[])
@@ -38,6 +39,8 @@ int main(int argc, char *argv[])
 
     QApplication application(argc, argv);
 
+    FRAMELESSHELPER_PREPEND_NAMESPACE(FramelessHelperWidgets)::initialize();
+
     Widget widget;
     widget.show();
 
@@ -25,31 +25,19 @@
 #include "widget.h"
 #include <QtCore/qdebug.h>
 #include <QtCore/qdatetime.h>
-#include <QtGui/qpainter.h>
 #include <QtWidgets/qboxlayout.h>
 #include <QtWidgets/qlabel.h>
 #include <QtWidgets/qpushbutton.h>
 #include "../../utilities.h"
 #include "../../framelesswindowsmanager.h"
+#include "../../framelessthemeapplier.h"
+#include "../../framelesswindowborderoverlay.h"
 
 FRAMELESSHELPER_USE_NAMESPACE
 
-static const QColor systemLightColor = QStringLiteral("#f0f0f0");
-static const QColor systemDarkColor = QColor::fromRgb(32, 32, 32);
-
+// Only the parts which never change, the theme colors are applied through the
+// palette by ThemeApplier.
 static constexpr char mainStyleSheet[] = R"(
-#MainWidget {
-    background-color: %1;
-}
-
-#TitleBarWidget {
-    background-color: %2;
-}
-
-#WindowTitleLabel {
-    color: %3;
-}
-
 #MinimizeButton, #MaximizeButton, #CloseButton {
     border-style: none;
     background-color: transparent;
@@ -70,10 +58,6 @@ static constexpr char mainStyleSheet[] = R"(
 #CloseButton:pressed {
     background-color: #8c0a15;
 }
-
-#ClockLabel {
-    color: %4;
-}
 )";
 
 Widget::Widget(QWidget *parent) : QWidget(parent)
@@ -118,49 +102,11 @@ void Widget::timerEvent(QTimerEvent *event)
 void Widget::changeEvent(QEvent *event)
 {
     QWidget::changeEvent(event);
-    bool shouldUpdate = false;
     if (event->type() == QEvent::WindowStateChange) {
         const int margin = ((isMaximized() || isFullScreen()) ? 0 : Utilities::getWindowVisibleFrameBorderThickness(winId()));
         setContentsMargins(margin, margin, margin, margin);
         updateSystemButtonIcons();
         updateTitleBarSize();
-        shouldUpdate = true;
-    } else if (event->type() == QEvent::ActivationChange) {
-        shouldUpdate = true;
-    }
-    if (shouldUpdate) {
-        updateStyleSheet();
-    }
-}
-
-void Widget::paintEvent(QPaintEvent *event)
-{
-    QWidget::paintEvent(event);
-    if (!isMaximized() && !isFullScreen()) {
-        QPainter painter(this);
-        painter.save();
-        painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
-        const auto w = static_cast<qreal>(width());
-        const auto h = static_cast<qreal>(height());
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        using BorderLines = QList<QLineF>;
-#else
-        using BorderLines = QVector<QLineF>;
-#endif
-        const BorderLines lines = {
-            {0, 0, w, 0},
-            {w, 0, w , h},
-            {w, h, 0, h},
-            {0, h, 0, 0}
-        };
-        const ColorizationArea area = Utilities::getColorizationArea();
-        const bool colorizedBorder = ((area == ColorizationArea::TitleBar_WindowBorder)
-                                      || (area == ColorizationArea::All));
-        const QColor borderColor = (isActiveWindow() ? (colorizedBorder ? Utilities::getColorizationColor() : Qt::black) : Qt::darkGray);
-        const auto borderThickness = static_cast<qreal>(Utilities::getWindowVisibleFrameBorderThickness(winId()));
-        painter.setPen({borderColor, borderThickness});
-        painter.drawLines(lines);
-        painter.restore();
     }
 }
 
@@ -229,45 +175,14 @@ void Widget::setupUi()
     mainLayout->addLayout(contentLayout);
     mainLayout->addStretch();
     setLayout(mainLayout);
-    updateStyleSheet();
-}
-
-void Widget::updateStyleSheet()
-{
-    const bool active = isActiveWindow();
-    const bool dark = Utilities::shouldAppsUseDarkMode();
-    const ColorizationArea area = Utilities::getColorizationArea();
-    const bool colorizedTitleBar = ((area == ColorizationArea::TitleBar_WindowBorder)
-                                    || (area == ColorizationArea::All));
-    const QColor colorizationColor = Utilities::getColorizationColor();
-    const QColor mainWidgetBackgroundColor = (dark ? systemDarkColor : systemLightColor);
-    const QColor titleBarWidgetBackgroundColor = [active, colorizedTitleBar, &colorizationColor, dark]{
-        if (active) {
-            if (colorizedTitleBar) {
-                return colorizationColor;
-            } else {
-                if (dark) {
-                    return QColor(Qt::black);
-                } else {
-                    return QColor(Qt::white);
-                }
-            }
-        } else {
-            if (dark) {
-                return systemDarkColor;
-            } else {
-                return QColor(Qt::white);
-            }
-        }
-    }();
-    const QColor windowTitleLabelTextColor = (active ? (dark ? Qt::white : Qt::black) : Qt::darkGray);
-    const QColor clockLabelTextColor = (dark ? Qt::white : Qt::black);
-    setStyleSheet(QString::fromUtf8(mainStyleSheet)
-                  .arg(mainWidgetBackgroundColor.name(),
-                       titleBarWidgetBackgroundColor.name(),
-                       windowTitleLabelTextColor.name(),
-                       clockLabelTextColor.name()));
-    update();
+    setStyleSheet(QString::fromUtf8(mainStyleSheet));
+    m_themeApplier = new ThemeApplier(this);
+    m_themeApplier->addWidget(m_titleBarWidget, ThemeApplier::Role::TitleBarBackground);
+    m_themeApplier->addWidget(m_windowTitleLabel, ThemeApplier::Role::TitleBarText);
+    m_themeApplier->addWidget(m_clockLabel, ThemeApplier::Role::Text);
+    // The icons only depend on the dark mode, not on the activation state.
+    connect(m_themeApplier, &ThemeApplier::darkModeChanged, this, &Widget::updateSystemButtonIcons);
+    new WindowBorderOverlay(this);
 }
 
 void Widget::updateTitleBarSize()
@@ -313,11 +228,6 @@ bool Widget::nativeEvent(const QByteArray &eventType, void *message, long *resul
 #endif
 {
     if (message) {
-        if (Utilities::isThemeChanged(message)) {
-            updateStyleSheet();
-            updateSystemButtonIcons();
-            return true;
-        }
         QPointF pos = {};
         if (Utilities::isSystemMenuRequested(message, &pos)) {
             if (Utilities::showSystemMenu(winId(), pos)) {
@@ -25,12 +25,17 @@
 #pragma once
 
 #include <QtWidgets/qwidget.h>
+#include "../../framelesshelper_global.h"
 
 QT_BEGIN_NAMESPACE
 QT_FORWARD_DECLARE_CLASS(QLabel)
 QT_FORWARD_DECLARE_CLASS(QPushButton)
 QT_END_NAMESPACE
 
+FRAMELESSHELPER_BEGIN_NAMESPACE
+class ThemeApplier;
+FRAMELESSHELPER_END_NAMESPACE
+
 class Widget : public QWidget
 {
     Q_OBJECT
@@ -43,7 +48,6 @@ protected:
     void showEvent(QShowEvent *event) override;
     void timerEvent(QTimerEvent *event) override;
     void changeEvent(QEvent *event) override;
-    void paintEvent(QPaintEvent *event) override;
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     bool nativeEvent(const QByteArray &eventType, void *message, qintptr *result) override;
 #else
@@ -52,7 +56,6 @@ protected:
 
 private:
     void setupUi();
-    void updateStyleSheet();
     void updateTitleBarSize();
     void updateSystemButtonIcons();
 
@@ -63,4 +66,5 @@ private:
     QPushButton *m_maximizeButton = nullptr;
     QPushButton *m_closeButton = nullptr;
     QLabel *m_clockLabel = nullptr;
+    FRAMELESSHELPER_PREPEND_NAMESPACE(ThemeApplier) *m_themeApplier = nullptr;
 };
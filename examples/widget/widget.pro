@@ -3,4 +3,5 @@ TEMPLATE = app
 QT += widgets
 HEADERS += widget.h
 SOURCES += widget.cpp main.cpp
+FRAMELESSHELPER_LIBS += FramelessHelperWidgets
 include($$PWD/../common.pri)
@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesscaptionupdatecoalescer.h"
+#include <QtCore/qmath.h>
+#include "framelessframepacer.h"
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr const int kFallbackRefreshRate = 60;
+
+CaptionUpdateCoalescer::CaptionUpdateCoalescer(FramePacerClock *clock) : m_clock(clock)
+{
+    Q_ASSERT(clock);
+}
+
+CaptionUpdateCoalescer::~CaptionUpdateCoalescer() = default;
+
+int CaptionUpdateCoalescer::schedule(const quintptr window)
+{
+    Q_ASSERT(window);
+    if (!window || m_clock.isNull()) {
+        return -1;
+    }
+    ++m_requestedUpdates;
+    WindowState &state = m_windows[window];
+    if (state.pending) {
+        return -1;
+    }
+    const qint64 now = m_clock->now();
+    state.due = (state.updated ? qMax(now, (state.lastUpdate + frameInterval())) : now);
+    state.pending = true;
+    return toMilliseconds(state.due - now);
+}
+
+QList<quintptr> CaptionUpdateCoalescer::takeDueWindows()
+{
+    if (m_clock.isNull() || m_windows.isEmpty()) {
+        return {};
+    }
+    const qint64 now = m_clock->now();
+    const qint64 interval = frameInterval();
+    QList<quintptr> windows = {};
+    auto it = m_windows.begin();
+    while (it != m_windows.end()) {
+        WindowState &state = it.value();
+        if (state.pending && (state.due <= now)) {
+            state.pending = false;
+            state.updated = true;
+            state.lastUpdate = now;
+            windows.append(it.key());
+            ++m_performedUpdates;
+            ++it;
+        } else if (!state.pending && ((now - state.lastUpdate) >= interval)) {
+            // Doesn't throttle anything anymore.
+            it = m_windows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return windows;
+}
+
+int CaptionUpdateCoalescer::nextDelay() const
+{
+    if (m_clock.isNull()) {
+        return -1;
+    }
+    const qint64 now = m_clock->now();
+    bool found = false;
+    qint64 due = 0;
+    for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
+        if (!it.value().pending) {
+            continue;
+        }
+        due = (found ? qMin(due, it.value().due) : it.value().due);
+        found = true;
+    }
+    if (!found) {
+        return -1;
+    }
+    return toMilliseconds(qMax(qint64(0), (due - now)));
+}
+
+bool CaptionUpdateCoalescer::isPending(const quintptr window) const
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    const auto it = m_windows.constFind(window);
+    return ((it != m_windows.constEnd()) && it.value().pending);
+}
+
+void CaptionUpdateCoalescer::removeWindow(const quintptr window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    m_windows.remove(window);
+}
+
+quint64 CaptionUpdateCoalescer::requestedUpdates() const
+{
+    return m_requestedUpdates;
+}
+
+quint64 CaptionUpdateCoalescer::performedUpdates() const
+{
+    return m_performedUpdates;
+}
+
+void CaptionUpdateCoalescer::invalidateFrameInterval()
+{
+    m_frameInterval = 0;
+}
+
+qint64 CaptionUpdateCoalescer::frameInterval()
+{
+    if (m_frameInterval > 0) {
+        return m_frameInterval;
+    }
+    // Asking the compositor is a system call, don't do it for every update.
+    qint64 vblank = 0, period = 0;
+    if (m_clock->getVBlank(&vblank, &period) && (period > 0)) {
+        m_frameInterval = period;
+    } else {
+        m_frameInterval = (m_clock->frequency() / kFallbackRefreshRate);
+    }
+    return m_frameInterval;
+}
+
+int CaptionUpdateCoalescer::toMilliseconds(const qint64 ticks) const
+{
+    const qint64 frequency = m_clock->frequency();
+    if ((ticks <= 0) || (frequency <= 0)) {
+        return 0;
+    }
+    // Round up, a timer firing a little early would find nothing due yet.
+    return qCeil((1000.0 * static_cast<qreal>(ticks)) / static_cast<qreal>(frequency));
+}
+
+FRAMELESSHELPER_END_NAMESPACE
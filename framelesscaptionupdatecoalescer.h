@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qscopedpointer.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FramePacerClock;
+
+// Title and icon changes force the whole window frame to be re-evaluated, which
+// is expensive. Batches them per window, so that each window gets at most one
+// native update per frame, no matter how often its title or icon changes.
+class FRAMELESSHELPER_API CaptionUpdateCoalescer
+{
+    Q_DISABLE_COPY_MOVE(CaptionUpdateCoalescer)
+
+public:
+    // Takes the ownership of the clock.
+    explicit CaptionUpdateCoalescer(FramePacerClock *clock);
+    ~CaptionUpdateCoalescer();
+
+    // Called for each title or icon change of the window. Returns the time left
+    // until its native update is due (in milliseconds), the caller is expected
+    // to call takeDueWindows() then. Returns -1 if an update has already been
+    // scheduled for this window.
+    [[nodiscard]] int schedule(const quintptr window);
+    // The windows whose native update is due now, they are no longer pending.
+    [[nodiscard]] QList<quintptr> takeDueWindows();
+    // The time left until the next pending update is due (in milliseconds), or
+    // -1 if there's none.
+    [[nodiscard]] int nextDelay() const;
+    [[nodiscard]] bool isPending(const quintptr window) const;
+    void removeWindow(const quintptr window);
+    // The frame interval is queried once and kept, call this when the display
+    // configuration changes (WM_DISPLAYCHANGE), the refresh rate may be a
+    // different one now.
+    void invalidateFrameInterval();
+
+    [[nodiscard]] quint64 requestedUpdates() const;
+    [[nodiscard]] quint64 performedUpdates() const;
+
+private:
+    [[nodiscard]] qint64 frameInterval();
+    [[nodiscard]] int toMilliseconds(const qint64 ticks) const;
+
+private:
+    struct WindowState
+    {
+        qint64 lastUpdate = 0;
+        qint64 due = 0;
+        bool updated = false;
+        bool pending = false;
+    };
+
+    QScopedPointer<FramePacerClock> m_clock;
+    QHash<quintptr, WindowState> m_windows = {};
+    // In ticks of the clock, 0 if it has to be queried again.
+    qint64 m_frameInterval = 0;
+    quint64 m_requestedUpdates = 0;
+    quint64 m_performedUpdates = 0;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
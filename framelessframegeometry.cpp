@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessframegeometry.h"
+#include "framelessstatistics.h"
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+QMargins FrameGeometry::calculateClientMargins(const FrameGeometryState &state)
+{
+    QMargins margins = {};
+    // We don't need this correction when we're fullscreen. We will have the
+    // WS_POPUP size, so we don't have to worry about borders, and the default
+    // frame will be fine.
+    if (state.maximized && !state.fullScreen) {
+        // A maximized window is a little bit larger than the work area of the
+        // monitor, its resize borders are positioned outside of the monitor.
+        const int thickness = qMax(0, state.resizeBorderThickness);
+        margins = {thickness, thickness, thickness, thickness};
+    }
+    if ((state.maximized || state.fullScreen) && (state.autoHideTaskbarEdges != Qt::Edges{})) {
+        // Leave a thin gap on the taskbar side so that the user can still reveal
+        // it with the mouse, Windows would treat us as a full screen window and
+        // keep the taskbar hidden otherwise. Only one edge is taken into account,
+        // just like what the system itself does.
+        const int thickness = state.autoHideTaskbarThickness;
+        const Qt::Edges edges = state.autoHideTaskbarEdges;
+        if (edges & Qt::TopEdge) {
+            margins.setTop(margins.top() + thickness);
+        } else if (edges & Qt::BottomEdge) {
+            margins.setBottom(margins.bottom() + thickness);
+        } else if (edges & Qt::LeftEdge) {
+            margins.setLeft(margins.left() + thickness);
+        } else if (edges & Qt::RightEdge) {
+            margins.setRight(margins.right() + thickness);
+        }
+    }
+    return margins;
+}
+
+ShellStateProvider::~ShellStateProvider() = default;
+
+ShellStateCache::ShellStateCache(ShellStateProvider *provider) : m_provider(provider)
+{
+    Q_ASSERT(provider);
+}
+
+ShellStateCache::~ShellStateCache() = default;
+
+Qt::Edges ShellStateCache::getAutoHideTaskbarEdges(const quintptr monitor)
+{
+    if (m_provider.isNull()) {
+        return {};
+    }
+    QMutexLocker locker(&m_mutex);
+    if (!m_autoHideValid) {
+        m_autoHide = m_provider->isTaskbarAutoHide();
+        m_autoHideValid = true;
+    } else {
+        FRAMELESSHELPER_STATISTICS_INCREMENT(nullptr, MetricCacheHits);
+    }
+    if (!m_autoHide) {
+        return {};
+    }
+    auto it = m_edges.constFind(monitor);
+    if (it == m_edges.constEnd()) {
+        it = m_edges.insert(monitor, m_provider->getAutoHideTaskbarEdges(monitor));
+    } else {
+        FRAMELESSHELPER_STATISTICS_INCREMENT(nullptr, MetricCacheHits);
+    }
+    return it.value();
+}
+
+void ShellStateCache::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_autoHideValid = false;
+    m_edges.clear();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
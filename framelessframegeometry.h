@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qmargins.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopedpointer.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Everything the client area of a frameless window depends on, gathered before
+// the calculation so that the calculation itself doesn't talk to the system.
+struct FrameGeometryState
+{
+    bool maximized = false;
+    bool fullScreen = false;
+    // In device pixels, already scaled for the DPI of the window's monitor.
+    int resizeBorderThickness = 0;
+    // The edges of the window's monitor which have an auto-hide taskbar.
+    Qt::Edges autoHideTaskbarEdges = {};
+    int autoHideTaskbarThickness = 2;
+};
+
+namespace FrameGeometry
+{
+
+// How much the proposed window rectangle has to shrink to become the client
+// rectangle (WM_NCCALCSIZE on Win32). The client area covers the whole window
+// unless it's maximized (the resize borders are outside of the monitor then) or
+// an auto-hide taskbar has to remain reachable.
+[[nodiscard]] FRAMELESSHELPER_API QMargins calculateClientMargins(const FrameGeometryState &state);
+
+}
+
+// Where the shell state comes from, the real implementation asks the Win32 shell.
+class FRAMELESSHELPER_API ShellStateProvider
+{
+public:
+    explicit ShellStateProvider() = default;
+    virtual ~ShellStateProvider();
+
+    [[nodiscard]] virtual bool isTaskbarAutoHide() const = 0;
+    // "monitor" is an opaque handle of the monitor (HMONITOR on Win32).
+    [[nodiscard]] virtual Qt::Edges getAutoHideTaskbarEdges(const quintptr monitor) const = 0;
+
+private:
+    Q_DISABLE_COPY_MOVE(ShellStateProvider)
+};
+
+// Remembers the answers of a ShellStateProvider until the shell state may have
+// changed, which is announced by WM_SETTINGCHANGE and WM_DISPLAYCHANGE on Win32.
+// Thread-safe.
+class FRAMELESSHELPER_API ShellStateCache
+{
+    Q_DISABLE_COPY_MOVE(ShellStateCache)
+
+public:
+    // Takes the ownership of the provider.
+    explicit ShellStateCache(ShellStateProvider *provider);
+    ~ShellStateCache();
+
+    [[nodiscard]] Qt::Edges getAutoHideTaskbarEdges(const quintptr monitor);
+    void invalidate();
+
+private:
+    QScopedPointer<ShellStateProvider> m_provider;
+    QMutex m_mutex;
+    bool m_autoHideValid = false;
+    bool m_autoHide = false;
+    QHash<quintptr, Qt::Edges> m_edges = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessframepacer.h"
+#include <QtCore/qmath.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+FramePacerClock::~FramePacerClock() = default;
+
+FramePacer::FramePacer(FramePacerClock *clock) : m_clock(clock)
+{
+    Q_ASSERT(clock);
+}
+
+FramePacer::~FramePacer() = default;
+
+FramePacingMode FramePacer::mode() const
+{
+    return m_mode;
+}
+
+void FramePacer::setMode(const FramePacingMode value)
+{
+    m_mode = value;
+}
+
+int FramePacer::pace(const quintptr window)
+{
+    if ((m_mode == FramePacingMode::Off) || m_clock.isNull()) {
+        return -1;
+    }
+    const qint64 frequency = m_clock->frequency();
+    if (frequency <= 0) {
+        return -1;
+    }
+    const qint64 start = m_clock->now();
+    if (m_mode == FramePacingMode::Deferred) {
+        const auto it = m_pendingWindows.constFind(window);
+        // The pending update already happens at the next vertical blank. Give
+        // up on it if it's overdue by a second, a window destroyed before its
+        // update never reports back and its handle may be reused.
+        if ((it != m_pendingWindows.constEnd()) && (start < (it.value() + frequency))) {
+            return -1;
+        }
+    }
+    qint64 vblank = 0, period = 0;
+    if (!m_clock->getVBlank(&vblank, &period)) {
+        return -1;
+    }
+    const qint64 wait = ticksUntilNextVBlank(m_clock->now(), vblank, period);
+    int result = -1;
+    if (m_mode == FramePacingMode::SleepToVBlank) {
+        m_clock->sleep(wait);
+    } else {
+        result = qRound((1000.0 * static_cast<qreal>(wait)) / static_cast<qreal>(frequency));
+        m_pendingWindows.insert(window, (start + wait));
+    }
+    const qint64 elapsed = (m_clock->now() - start);
+    m_blockedTime.fetch_add(qRound64((1000000000.0 * static_cast<qreal>(elapsed)) / static_cast<qreal>(frequency)),
+                            std::memory_order_relaxed);
+    m_pacedFrames.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+void FramePacer::deferredUpdateDone(const quintptr window)
+{
+    m_pendingWindows.remove(window);
+}
+
+bool FramePacer::isDeferredUpdatePending(const quintptr window) const
+{
+    return m_pendingWindows.contains(window);
+}
+
+void FramePacer::removeWindow(const quintptr window)
+{
+    m_pendingWindows.remove(window);
+}
+
+qint64 FramePacer::blockedTime() const
+{
+    return m_blockedTime.load(std::memory_order_relaxed);
+}
+
+quint64 FramePacer::pacedFrames() const
+{
+    return m_pacedFrames.load(std::memory_order_relaxed);
+}
+
+qint64 FramePacer::ticksUntilNextVBlank(const qint64 now, const qint64 vblank, const qint64 period)
+{
+    if (period <= 0) {
+        return 0;
+    }
+    // The compositor tells us about SOME vertical blank, possibly many frames
+    // away in either direction, only its phase is interesting.
+    qint64 remainder = ((vblank - now) % period);
+    if (remainder < 0) {
+        remainder += period;
+    }
+    return remainder;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qhash.h>
+#include <atomic>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The time source of FramePacer. All values are in ticks of the same clock.
+class FRAMELESSHELPER_API FramePacerClock
+{
+public:
+    explicit FramePacerClock() = default;
+    virtual ~FramePacerClock();
+
+    // Ticks per second.
+    [[nodiscard]] virtual qint64 frequency() const = 0;
+    [[nodiscard]] virtual qint64 now() const = 0;
+    // Any vertical blank, past or future, and the refresh period.
+    [[nodiscard]] virtual bool getVBlank(qint64 *vblank, qint64 *period) const = 0;
+    virtual void sleep(const qint64 ticks) = 0;
+
+private:
+    Q_DISABLE_COPY_MOVE(FramePacerClock)
+};
+
+// Synchronizes the window resizing with the vertical blank of the compositor,
+// which avoids the flicker of the DWM while a window is being resized.
+class FRAMELESSHELPER_API FramePacer
+{
+    Q_DISABLE_COPY_MOVE(FramePacer)
+
+public:
+    // Takes the ownership of the clock.
+    explicit FramePacer(FramePacerClock *clock);
+    ~FramePacer();
+
+    [[nodiscard]] FramePacingMode mode() const;
+    void setMode(const FramePacingMode value);
+
+    // Called once per resize step of the window. Blocks until the next vertical
+    // blank in the SleepToVBlank mode. In the Deferred mode it returns immediately
+    // with the time left until the next vertical blank (in milliseconds), the
+    // caller is expected to schedule its update for then and to call
+    // deferredUpdateDone() once it's done. Returns -1 if there's nothing to
+    // schedule, which includes a window whose deferred update is still pending.
+    [[nodiscard]] int pace(const quintptr window);
+    void deferredUpdateDone(const quintptr window);
+    [[nodiscard]] bool isDeferredUpdatePending(const quintptr window) const;
+    void removeWindow(const quintptr window);
+
+    // The total time the calling thread has spent inside pace(), in nanoseconds.
+    [[nodiscard]] qint64 blockedTime() const;
+    [[nodiscard]] quint64 pacedFrames() const;
+
+    // Converts an arbitrary vertical blank into the distance to the next one,
+    // the result is always in [0, period).
+    [[nodiscard]] static qint64 ticksUntilNextVBlank(const qint64 now, const qint64 vblank, const qint64 period);
+
+private:
+    QScopedPointer<FramePacerClock> m_clock;
+    FramePacingMode m_mode = FramePacingMode::SleepToVBlank;
+    std::atomic<qint64> m_blockedTime{0};
+    std::atomic<quint64> m_pacedFrames{0};
+    // When the pending deferred update of each window is due, only touched by
+    // the thread which paces, the GUI thread.
+    QHash<quintptr, qint64> m_pendingWindows = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessframesnapshot.h"
+#include "framelesswindowsmanager.h"
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+FrameConfiguration FrameConfigurationSnapshot::load() const noexcept
+{
+    FrameConfiguration value = {};
+    quint32 before = 0;
+    quint32 after = 0;
+    do {
+        before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            // The writer is in the middle of an update.
+            continue;
+        }
+        value.frameless = m_frameless.load(std::memory_order_relaxed);
+        value.resizable = m_resizable.load(std::memory_order_relaxed);
+        value.windowState = static_cast<Qt::WindowState>(m_windowState.load(std::memory_order_relaxed));
+        value.resizeBorderThickness = m_resizeBorderThickness.load(std::memory_order_relaxed);
+        value.titleBarHeight = m_titleBarHeight.load(std::memory_order_relaxed);
+        value.cornerRadius = m_cornerRadius.load(std::memory_order_relaxed);
+        value.devicePixelRatio = m_devicePixelRatio.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || (before != after));
+    return value;
+}
+
+void FrameConfigurationSnapshot::store(const FrameConfiguration &value) noexcept
+{
+    const quint32 sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_frameless.store(value.frameless, std::memory_order_relaxed);
+    m_resizable.store(value.resizable, std::memory_order_relaxed);
+    m_windowState.store(static_cast<int>(value.windowState), std::memory_order_relaxed);
+    m_resizeBorderThickness.store(value.resizeBorderThickness, std::memory_order_relaxed);
+    m_titleBarHeight.store(value.titleBarHeight, std::memory_order_relaxed);
+    m_cornerRadius.store(value.cornerRadius, std::memory_order_relaxed);
+    m_devicePixelRatio.store(value.devicePixelRatio, std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void FrameConfigurationSnapshot::update(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    FrameConfiguration value = {};
+    value.frameless = FramelessWindowsManager::isWindowFrameless(window);
+    value.resizable = FramelessWindowsManager::getResizable(window);
+    value.windowState = window->windowState();
+    value.resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(window);
+    value.titleBarHeight = FramelessWindowsManager::getTitleBarHeight(window);
+    value.cornerRadius = FramelessWindowsManager::getCornerRadius(window);
+    value.devicePixelRatio = window->devicePixelRatio();
+    store(value);
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+struct FrameConfiguration
+{
+    bool frameless = false;
+    bool resizable = true;
+    Qt::WindowState windowState = Qt::WindowNoState;
+    int resizeBorderThickness = 0;
+    int titleBarHeight = 0;
+    qreal cornerRadius = 0.0;
+    qreal devicePixelRatio = 1.0;
+};
+
+// Holds the latest frame configuration of one window. It has exactly one writer at
+// a time (the thread which owns the window, or the render thread while the GUI
+// thread is blocked for synchronization) and any number of readers, on any thread,
+// which never block: a reader simply retries if it raced with the writer.
+class FRAMELESSHELPER_API FrameConfigurationSnapshot
+{
+    Q_DISABLE_COPY_MOVE(FrameConfigurationSnapshot)
+
+public:
+    explicit FrameConfigurationSnapshot() = default;
+    ~FrameConfigurationSnapshot() = default;
+
+    [[nodiscard]] FrameConfiguration load() const noexcept;
+    void store(const FrameConfiguration &value) noexcept;
+
+    // Must be called with the GUI thread being blocked, or on the GUI thread itself.
+    void update(const QWindow *window);
+
+private:
+    std::atomic<quint32> m_sequence{0};
+    std::atomic<bool> m_frameless{false};
+    std::atomic<bool> m_resizable{true};
+    std::atomic<int> m_windowState{Qt::WindowNoState};
+    std::atomic<int> m_resizeBorderThickness{0};
+    std::atomic<int> m_titleBarHeight{0};
+    std::atomic<qreal> m_cornerRadius{0.0};
+    std::atomic<qreal> m_devicePixelRatio{1.0};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,215 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessglyphatlas.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qpainter.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr qreal kGlyphSize = 10.0;
+static constexpr int kGlyphCount = 4;
+
+using GlyphAtlasKey = QPair<qreal, QRgb>;
+
+struct GlyphAtlasEntry
+{
+    qreal devicePixelRatio = 1.0;
+    QColor color = {};
+    int cellSize = 0;
+    QImage image = {};
+    int refCount = 0;
+};
+
+struct GlyphAtlasRegistry
+{
+    QMutex mutex;
+    QHash<GlyphAtlasKey, GlyphAtlasEntry *> entries = {};
+};
+
+Q_GLOBAL_STATIC(GlyphAtlasRegistry, g_glyphAtlasRegistry)
+
+// All the glyphs live in a single image, one square cell per glyph, so that each
+// consumer needs only one pixmap or texture for them.
+[[nodiscard]] static inline QImage renderGlyphAtlas(const int cellSize, const qreal devicePixelRatio, const QColor &color)
+{
+    QImage atlas(cellSize * kGlyphCount, cellSize, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+    QPainter painter(&atlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const qreal penWidth = qMax(1.0, devicePixelRatio);
+    painter.setPen(QPen(color, penWidth, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin));
+    painter.setBrush(Qt::NoBrush);
+    const qreal half = (penWidth / 2.0);
+    const auto cellRect = [cellSize, half](const SystemButtonGlyph glyph) -> QRectF {
+        const qreal x = static_cast<qreal>(static_cast<int>(glyph) * cellSize);
+        return QRectF(x, 0.0, cellSize, cellSize).adjusted(half, half, -half, -half);
+    };
+    {
+        const QRectF rect = cellRect(SystemButtonGlyph::Minimize);
+        const qreal y = qRound(rect.center().y()) + half;
+        painter.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+    }
+    painter.drawRect(cellRect(SystemButtonGlyph::Maximize));
+    {
+        const QRectF rect = cellRect(SystemButtonGlyph::Restore);
+        const qreal offset = qRound(static_cast<qreal>(cellSize) / 5.0);
+        const QRectF front = rect.adjusted(0.0, offset, -offset, 0.0);
+        painter.drawRect(front);
+        painter.drawPolyline(QPolygonF({
+            QPointF(front.left() + offset, front.top()),
+            QPointF(rect.left() + offset, rect.top()),
+            QPointF(rect.right(), rect.top()),
+            QPointF(rect.right(), front.bottom() - offset),
+            QPointF(front.right(), front.bottom() - offset)
+        }));
+    }
+    {
+        const QRectF rect = cellRect(SystemButtonGlyph::Close);
+        painter.drawLine(rect.topLeft(), rect.bottomRight());
+        painter.drawLine(rect.topRight(), rect.bottomLeft());
+    }
+    painter.end();
+    return atlas;
+}
+
+[[nodiscard]] static inline GlyphAtlasEntry *acquireEntry(const qreal devicePixelRatio, const QColor &color)
+{
+    const qreal dpr = ((devicePixelRatio > 0.0) ? devicePixelRatio : 1.0);
+    const GlyphAtlasKey key = qMakePair(dpr, color.rgba());
+    QMutexLocker locker(&g_glyphAtlasRegistry()->mutex);
+    GlyphAtlasEntry *entry = g_glyphAtlasRegistry()->entries.value(key);
+    if (!entry) {
+        // Four small glyphs, cheap enough to be done while holding the lock.
+        entry = new GlyphAtlasEntry;
+        entry->devicePixelRatio = dpr;
+        entry->color = color;
+        entry->cellSize = qCeil(kGlyphSize * dpr);
+        entry->image = renderGlyphAtlas(entry->cellSize, dpr, color);
+        g_glyphAtlasRegistry()->entries.insert(key, entry);
+    }
+    ++entry->refCount;
+    return entry;
+}
+
+static inline void addEntryRef(GlyphAtlasEntry *entry)
+{
+    if (!entry) {
+        return;
+    }
+    QMutexLocker locker(&g_glyphAtlasRegistry()->mutex);
+    ++entry->refCount;
+}
+
+static inline void releaseEntry(GlyphAtlasEntry *entry)
+{
+    if (!entry) {
+        return;
+    }
+    QMutexLocker locker(&g_glyphAtlasRegistry()->mutex);
+    if (--entry->refCount > 0) {
+        return;
+    }
+    g_glyphAtlasRegistry()->entries.remove(qMakePair(entry->devicePixelRatio, entry->color.rgba()));
+    delete entry;
+}
+
+GlyphAtlas::GlyphAtlas(const qreal devicePixelRatio, const QColor &color)
+{
+    m_entry = acquireEntry(devicePixelRatio, color);
+}
+
+GlyphAtlas::GlyphAtlas(const GlyphAtlas &other) : m_entry(other.m_entry)
+{
+    addEntryRef(m_entry);
+}
+
+GlyphAtlas &GlyphAtlas::operator=(const GlyphAtlas &other)
+{
+    if (m_entry != other.m_entry) {
+        addEntryRef(other.m_entry);
+        releaseEntry(m_entry);
+        m_entry = other.m_entry;
+    }
+    return *this;
+}
+
+GlyphAtlas::GlyphAtlas(GlyphAtlas &&other) noexcept : m_entry(qExchange(other.m_entry, nullptr)) {}
+
+GlyphAtlas &GlyphAtlas::operator=(GlyphAtlas &&other) noexcept
+{
+    if (this != &other) {
+        releaseEntry(m_entry);
+        m_entry = qExchange(other.m_entry, nullptr);
+    }
+    return *this;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    releaseEntry(m_entry);
+}
+
+bool GlyphAtlas::isNull() const
+{
+    return !m_entry;
+}
+
+qreal GlyphAtlas::devicePixelRatio() const
+{
+    return (m_entry ? m_entry->devicePixelRatio : 1.0);
+}
+
+QColor GlyphAtlas::color() const
+{
+    return (m_entry ? m_entry->color : QColor{});
+}
+
+QImage GlyphAtlas::image() const
+{
+    // Never modified once created, no need to lock.
+    return (m_entry ? m_entry->image : QImage{});
+}
+
+QRect GlyphAtlas::glyphRect(const SystemButtonGlyph glyph) const
+{
+    if (!m_entry) {
+        return {};
+    }
+    const int cellSize = m_entry->cellSize;
+    return {static_cast<int>(glyph) * cellSize, 0, cellSize, cellSize};
+}
+
+QSizeF GlyphAtlas::glyphSize() const
+{
+    if (!m_entry) {
+        return {};
+    }
+    const qreal size = (static_cast<qreal>(m_entry->cellSize) / m_entry->devicePixelRatio);
+    return {size, size};
+}
+
+FRAMELESSHELPER_END_NAMESPACE
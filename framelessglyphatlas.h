@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtGui/qcolor.h>
+#include <QtGui/qimage.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+enum class SystemButtonGlyph : int
+{
+    Minimize = 0,
+    Maximize,
+    Restore,
+    Close
+};
+
+struct GlyphAtlasEntry;
+
+// A reference to the process-wide atlas of the system button glyphs for one
+// (DPR, color) pair. Each atlas is rasterized only once, on first use, and it's
+// released as soon as the last reference to it goes away, e.g. when no window is
+// on a screen with that DPR anymore. References can be created, used and destroyed
+// on any thread, e.g. by the render thread of Qt Quick. A QPixmap made from the
+// image() belongs to the GUI thread, so its owner has to cache it itself.
+class FRAMELESSHELPER_API GlyphAtlas
+{
+public:
+    explicit GlyphAtlas() = default;
+    explicit GlyphAtlas(const qreal devicePixelRatio, const QColor &color);
+    GlyphAtlas(const GlyphAtlas &other);
+    GlyphAtlas &operator=(const GlyphAtlas &other);
+    GlyphAtlas(GlyphAtlas &&other) noexcept;
+    GlyphAtlas &operator=(GlyphAtlas &&other) noexcept;
+    ~GlyphAtlas();
+
+    [[nodiscard]] bool isNull() const;
+    [[nodiscard]] qreal devicePixelRatio() const;
+    [[nodiscard]] QColor color() const;
+
+    [[nodiscard]] QImage image() const;
+    // In device pixels, to be used as the source rectangle.
+    [[nodiscard]] QRect glyphRect(const SystemButtonGlyph glyph) const;
+    // In device independent pixels, to be used as the target size.
+    [[nodiscard]] QSizeF glyphSize() const;
+
+private:
+    GlyphAtlasEntry *m_entry = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
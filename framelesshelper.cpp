@@ -28,14 +28,124 @@
 
 #include <QtCore/qdebug.h>
 #include <QtGui/qevent.h>
-#include <QtGui/qwindow.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qstylehints.h>
+#include <QtGui/qrasterwindow.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpalette.h>
 #include "framelesswindowsmanager.h"
+#include "framelessstatistics.h"
+#include "framelesstracer.h"
 #include "utilities.h"
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
+static constexpr qreal kPenResizeBorderScale = 1.5;
+static constexpr qreal kTouchResizeBorderScale = 2.5;
+static constexpr int kResizeOutlineThickness = 3;
+
+// A very cheap window which only draws the border of the rubber band, the
+// inner part is masked out so we don't need any transparency support.
+class ResizeOutlineWindow : public QRasterWindow
+{
+    Q_DISABLE_COPY_MOVE(ResizeOutlineWindow)
+
+public:
+    explicit ResizeOutlineWindow() : QRasterWindow()
+    {
+        setFlags(Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowTransparentForInput
+                 | Qt::WindowDoesNotAcceptFocus);
+    }
+
+    ~ResizeOutlineWindow() override = default;
+
+    void setOutlineGeometry(const QRect &rect)
+    {
+        const QRect localRect = {QPoint(0, 0), rect.size()};
+        const QRect innerRect = localRect.adjusted(kResizeOutlineThickness, kResizeOutlineThickness,
+                                                   -kResizeOutlineThickness, -kResizeOutlineThickness);
+        setGeometry(rect);
+        setMask(QRegion(localRect).subtracted(innerRect));
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        Q_UNUSED(event);
+        QPainter painter(this);
+        painter.fillRect(QRect(QPoint(0, 0), size()), QGuiApplication::palette().color(QPalette::Highlight));
+    }
+};
+
+[[nodiscard]] static inline int getRefreshInterval(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const QScreen *screen = (window ? window->screen() : nullptr);
+    const qreal refreshRate = (screen ? screen->refreshRate() : 0.0);
+    return qMax(1, qRound(1000.0 / ((refreshRate > 0.0) ? refreshRate : 60.0)));
+}
+
+[[nodiscard]] static inline Qt::Edges getWindowEdges(const QWindow *window, const QPoint &pos, const int resizeBorderThickness)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(window, HitTests);
+    FRAMELESSHELPER_TRACE_SCOPE("getWindowEdges");
+    const int windowWidth = window->width();
+    const int windowHeight = window->height();
+    if (pos.y() <= resizeBorderThickness) {
+        if (pos.x() <= resizeBorderThickness) {
+            return Qt::TopEdge | Qt::LeftEdge;
+        }
+        if (pos.x() >= (windowWidth - resizeBorderThickness)) {
+            return Qt::TopEdge | Qt::RightEdge;
+        }
+        return Qt::Edges{Qt::TopEdge};
+    }
+    if (pos.y() >= (windowHeight - resizeBorderThickness)) {
+        if (pos.x() <= resizeBorderThickness) {
+            return Qt::BottomEdge | Qt::LeftEdge;
+        }
+        if (pos.x() >= (windowWidth - resizeBorderThickness)) {
+            return Qt::BottomEdge | Qt::RightEdge;
+        }
+        return Qt::Edges{Qt::BottomEdge};
+    }
+    if (pos.x() <= resizeBorderThickness) {
+        return Qt::Edges{Qt::LeftEdge};
+    }
+    if (pos.x() >= (windowWidth - resizeBorderThickness)) {
+        return Qt::Edges{Qt::RightEdge};
+    }
+    return {};
+}
+
 FramelessHelper::FramelessHelper(QObject *parent) : QObject(parent) {}
 
+FramelessHelper::~FramelessHelper() = default;
+
+int FramelessHelper::getResizeBorderThickness(const QWindow *window, const PointerType pointer)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return 0;
+    }
+    const int resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(window);
+    // Fingers and pens are far less precise than a mouse, give them wider resize bands.
+    switch (pointer) {
+    case PointerType::Mouse:
+        break;
+    case PointerType::Pen:
+        return qRound(static_cast<qreal>(resizeBorderThickness) * kPenResizeBorderScale);
+    case PointerType::Touch:
+        return qRound(static_cast<qreal>(resizeBorderThickness) * kTouchResizeBorderScale);
+    }
+    return resizeBorderThickness;
+}
+
 void FramelessHelper::removeWindowFrame(QWindow *window)
 {
     Q_ASSERT(window);
@@ -45,6 +155,14 @@ void FramelessHelper::removeWindowFrame(QWindow *window)
     window->setFlags(window->flags() | Qt::FramelessWindowHint);
     window->installEventFilter(this);
     window->setProperty(Constants::kFramelessModeFlag, true);
+    if (!m_pointerStates.contains(window)) {
+        PointerState state = {};
+        // The QWindow part is already gone at this point, only the address is used.
+        state.destroyedConnection = connect(window, &QObject::destroyed, this, [this, window](){
+            m_pointerStates.remove(window);
+        });
+        m_pointerStates.insert(window, state);
+    }
 }
 
 void FramelessHelper::bringBackWindowFrame(QWindow *window)
@@ -56,6 +174,432 @@ void FramelessHelper::bringBackWindowFrame(QWindow *window)
     window->removeEventFilter(this);
     window->setFlags(window->flags() & ~Qt::FramelessWindowHint);
     window->setProperty(Constants::kFramelessModeFlag, false);
+    if (!window->mask().isEmpty()) {
+        window->setMask({});
+    }
+    const auto motion = m_pendingMotions.find(window);
+    if (motion != m_pendingMotions.end()) {
+        killTimer(motion.value().timerId);
+        m_pendingMotions.erase(motion);
+    }
+    const auto state = m_pointerStates.find(window);
+    if (state != m_pointerStates.end()) {
+        disconnect(state.value().destroyedConnection);
+        m_pointerStates.erase(state);
+    }
+    if (m_outlineResize.window == window) {
+        stopOutlineResize(false);
+    }
+}
+
+void FramelessHelper::updateWindowMask(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    FRAMELESSHELPER_TRACE_SCOPE("updateWindowMask");
+    const qreal radius = FramelessWindowsManager::getCornerRadius(window);
+    const Qt::WindowState state = window->windowState();
+    const bool rounded = ((radius > 0.0) && (state != Qt::WindowMaximized) && (state != Qt::WindowFullScreen));
+    if (!rounded) {
+        if (!window->mask().isEmpty()) {
+            window->setMask({});
+        }
+        return;
+    }
+    window->setMask(Utilities::getRoundedCornerMask(window->size(), radius));
+}
+
+void FramelessHelper::scheduleWindowMaskUpdate(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    if ((FramelessWindowsManager::getCornerRadius(window) <= 0.0) && window->mask().isEmpty()) {
+        return;
+    }
+    for (auto it = m_maskUpdates.begin(); it != m_maskUpdates.end(); ++it) {
+        if (it.value().window == window) {
+            // An update has been applied during the current frame already, remember
+            // to apply the latest size once the frame is over.
+            it.value().pending = true;
+            return;
+        }
+    }
+    updateWindowMask(window);
+    const int timerId = startTimer(getRefreshInterval(window), Qt::PreciseTimer);
+    if (timerId != 0) {
+        m_maskUpdates.insert(timerId, {window, false});
+    }
+}
+
+void FramelessHelper::coalescePointerMove(QWindow *window, const QPoint &pos, const Qt::MouseButtons buttons, const PointerType pointer)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    PendingMotion &motion = m_pendingMotions[window];
+    if ((motion.timerId != 0) && !motion.window.isNull()) {
+        // The motion of the current frame has been processed already, only keep
+        // the latest position and evaluate it once the frame is over.
+        motion.pos = pos;
+        motion.buttons = buttons;
+        motion.pointer = pointer;
+        motion.pending = true;
+        return;
+    }
+    if (motion.timerId != 0) {
+        // Left over by a destroyed window which had the same address.
+        killTimer(motion.timerId);
+    }
+    motion = {window, pos, buttons, pointer, false, startTimer(getRefreshInterval(window), Qt::PreciseTimer)};
+    handlePointerMove(window, pos, buttons, pointer);
+}
+
+void FramelessHelper::flushPendingPointerMove(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const auto it = m_pendingMotions.find(window);
+    if ((it == m_pendingMotions.end()) || !it.value().pending) {
+        return;
+    }
+    it.value().pending = false;
+    handlePointerMove(window, it.value().pos, it.value().buttons, it.value().pointer);
+}
+
+void FramelessHelper::timerEvent(QTimerEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return;
+    }
+    const int timerId = event->timerId();
+    const auto mask = m_maskUpdates.find(timerId);
+    if (mask != m_maskUpdates.end()) {
+        if (mask.value().window && mask.value().pending) {
+            mask.value().pending = false;
+            updateWindowMask(mask.value().window);
+            return;
+        }
+        killTimer(timerId);
+        m_maskUpdates.erase(mask);
+        return;
+    }
+    for (auto it = m_pendingMotions.begin(); it != m_pendingMotions.end(); ++it) {
+        if (it.value().timerId != timerId) {
+            continue;
+        }
+        if (it.value().window && it.value().pending) {
+            it.value().pending = false;
+            handlePointerMove(it.value().window, it.value().pos, it.value().buttons, it.value().pointer);
+            return;
+        }
+        // No motion during the last frame, stop the timer until the pointer moves again.
+        killTimer(timerId);
+        m_pendingMotions.erase(it);
+        return;
+    }
+    QObject::timerEvent(event);
+}
+
+void FramelessHelper::handlePointerMove(QWindow *window, const QPoint &pos, const Qt::MouseButtons buttons, const PointerType pointer)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const int resizeBorderThickness = getResizeBorderThickness(window, pointer);
+    const bool resizable = FramelessWindowsManager::getResizable(window);
+    const Qt::Edges edges = getWindowEdges(window, pos, resizeBorderThickness);
+    PointerState &state = m_pointerStates[window];
+
+    // Display resize indicators
+    if ((window->windowState() == Qt::WindowState::WindowNoState) && resizable) {
+        if (((edges & Qt::TopEdge) && (edges & Qt::LeftEdge))
+                || ((edges & Qt::BottomEdge) && (edges & Qt::RightEdge))) {
+            window->setCursor(Qt::SizeFDiagCursor);
+            FRAMELESSHELPER_STATISTICS_INCREMENT(window, CursorChanges);
+            state.cursorChanged = true;
+        } else if (((edges & Qt::TopEdge) && (edges & Qt::RightEdge))
+                   || ((edges & Qt::BottomEdge) && (edges & Qt::LeftEdge))) {
+            window->setCursor(Qt::SizeBDiagCursor);
+            FRAMELESSHELPER_STATISTICS_INCREMENT(window, CursorChanges);
+            state.cursorChanged = true;
+        } else if ((edges & Qt::TopEdge) || (edges & Qt::BottomEdge)) {
+            window->setCursor(Qt::SizeVerCursor);
+            FRAMELESSHELPER_STATISTICS_INCREMENT(window, CursorChanges);
+            state.cursorChanged = true;
+        } else if ((edges & Qt::LeftEdge) || (edges & Qt::RightEdge)) {
+            window->setCursor(Qt::SizeHorCursor);
+            FRAMELESSHELPER_STATISTICS_INCREMENT(window, CursorChanges);
+            state.cursorChanged = true;
+        } else {
+            if (state.cursorChanged) {
+                window->setCursor(Qt::ArrowCursor);
+                FRAMELESSHELPER_STATISTICS_INCREMENT(window, CursorChanges);
+                state.cursorChanged = false;
+            }
+        }
+    }
+
+    if ((buttons & Qt::LeftButton) && state.titleBarClicked) {
+        if (edges == Qt::Edges{}) {
+            if (!Utilities::isHitTestVisible(window, pos)
+                    && Utilities::isInsideTitleBar(window, pos, resizeBorderThickness)) {
+                FRAMELESSHELPER_STATISTICS_INCREMENT(window, SystemMoves);
+                FRAMELESSHELPER_TRACE_SCOPE("startSystemMove");
+                if (!window->startSystemMove()) {
+                    // ### FIXME: TO BE IMPLEMENTED!
+                    qWarning() << "Current OS doesn't support QWindow::startSystemMove().";
+                }
+            }
+        }
+    }
+}
+
+bool FramelessHelper::handlePointerPress(QWindow *window, const QPoint &pos, const PointerType pointer)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    const int resizeBorderThickness = getResizeBorderThickness(window, pointer);
+    const Qt::Edges edges = getWindowEdges(window, pos, resizeBorderThickness);
+    // At the position of the event, the cursor is somewhere else for touch and pen input.
+    const bool hitTestVisible = Utilities::isHitTestVisible(window, pos);
+    // Determine if the press occurred in the title bar
+    m_pointerStates[window].titleBarClicked = (!hitTestVisible && Utilities::isInsideTitleBar(window, pos, resizeBorderThickness));
+    if (edges == Qt::Edges{}) {
+        return false;
+    }
+    if ((window->windowState() != Qt::WindowState::WindowNoState) || hitTestVisible
+            || !FramelessWindowsManager::getResizable(window)) {
+        return false;
+    }
+    // Falls back to the system resize if the outline can't be used.
+    if ((pointer == PointerType::Mouse) && FramelessWindowsManager::getOutlineResize(window)
+            && startOutlineResize(window, edges, window->mapToGlobal(pos))) {
+        return true;
+    }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(window, SystemResizes);
+    FRAMELESSHELPER_TRACE_SCOPE("startSystemResize");
+    if (!window->startSystemResize(edges)) {
+        // ### FIXME: TO BE IMPLEMENTED!
+        qWarning() << "Current OS doesn't support QWindow::startSystemResize().";
+        return false;
+    }
+    return true;
+}
+
+bool FramelessHelper::startOutlineResize(QWindow *window, const Qt::Edges edges, const QPoint &globalPos)
+{
+    Q_ASSERT(window);
+    if (!window || (edges == Qt::Edges{})) {
+        return false;
+    }
+    if (!m_outlineResize.window.isNull()) {
+        stopOutlineResize(false);
+    }
+    if (m_outlineWindow.isNull()) {
+        m_outlineWindow.reset(new ResizeOutlineWindow);
+        // We are a global static, the window must not outlive the application.
+        connect(qApp, &QCoreApplication::aboutToQuit, this, [this](){
+            stopOutlineResize(false);
+            m_outlineWindow.reset();
+        });
+    }
+    const QRect geometry = window->geometry();
+    m_outlineResize = {window, edges, globalPos, geometry, geometry};
+    const auto outlineWindow = static_cast<ResizeOutlineWindow *>(m_outlineWindow.data());
+    outlineWindow->setScreen(window->screen());
+    outlineWindow->setOutlineGeometry(geometry);
+    outlineWindow->show();
+    // Keep receiving the pointer events even if it leaves the window. Without the
+    // grabs the button release could be missed and the outline would stay forever.
+    if (!window->setMouseGrabEnabled(true) || !window->setKeyboardGrabEnabled(true)) {
+        stopOutlineResize(false);
+        return false;
+    }
+    return true;
+}
+
+void FramelessHelper::updateOutlineResize(const QPoint &globalPos)
+{
+    QWindow *window = m_outlineResize.window;
+    if (!window) {
+        stopOutlineResize(false);
+        return;
+    }
+    const QPoint delta = (globalPos - m_outlineResize.pressPos);
+    const QRect &start = m_outlineResize.startGeometry;
+    const Qt::Edges edges = m_outlineResize.edges;
+    const QSize minimumSize = window->minimumSize();
+    const QSize maximumSize = window->maximumSize();
+    int width = start.width();
+    int height = start.height();
+    if (edges & Qt::LeftEdge) {
+        width -= delta.x();
+    } else if (edges & Qt::RightEdge) {
+        width += delta.x();
+    }
+    if (edges & Qt::TopEdge) {
+        height -= delta.y();
+    } else if (edges & Qt::BottomEdge) {
+        height += delta.y();
+    }
+    width = qBound(qMax(1, minimumSize.width()), width, maximumSize.width());
+    height = qBound(qMax(1, minimumSize.height()), height, maximumSize.height());
+    // Keep the opposite edges where they are.
+    const int x = ((edges & Qt::LeftEdge) ? (start.right() - width + 1) : start.x());
+    const int y = ((edges & Qt::TopEdge) ? (start.bottom() - height + 1) : start.y());
+    const QRect geometry = {x, y, width, height};
+    if (geometry == m_outlineResize.geometry) {
+        return;
+    }
+    m_outlineResize.geometry = geometry;
+    if (!m_outlineWindow.isNull()) {
+        static_cast<ResizeOutlineWindow *>(m_outlineWindow.data())->setOutlineGeometry(geometry);
+    }
+}
+
+void FramelessHelper::stopOutlineResize(const bool apply)
+{
+    QWindow *window = m_outlineResize.window;
+    const QRect geometry = m_outlineResize.geometry;
+    m_outlineResize = {};
+    if (!m_outlineWindow.isNull()) {
+        m_outlineWindow->hide();
+    }
+    if (!window) {
+        return;
+    }
+    window->setMouseGrabEnabled(false);
+    window->setKeyboardGrabEnabled(false);
+    // Only the final geometry reaches the window, so its content is laid out once.
+    if (apply && (geometry != window->geometry())) {
+        window->setGeometry(geometry);
+    }
+}
+
+void FramelessHelper::toggleMaximized(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    if (window->windowState() == Qt::WindowState::WindowFullScreen) {
+        return;
+    }
+    if (window->windowState() == Qt::WindowState::WindowMaximized) {
+        window->showNormal();
+    } else {
+        window->showMaximized();
+    }
+    window->setCursor(Qt::ArrowCursor);
+}
+
+bool FramelessHelper::handleTouchEvent(QWindow *window, QTouchEvent *event)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(event);
+    if (!window || !event) {
+        return false;
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const auto &points = event->points();
+#else
+    const auto &points = event->touchPoints();
+#endif
+    PointerState &state = m_pointerStates[window];
+    // Multi-finger gestures are left to the application.
+    if (points.count() != 1) {
+        state.touchDragging = false;
+        return false;
+    }
+    const auto &point = points.first();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPoint pos = point.position().toPoint();
+    const QPoint pressPos = point.pressPosition().toPoint();
+#else
+    const QPoint pos = point.pos().toPoint();
+    const QPoint pressPos = point.startPos().toPoint();
+#endif
+    switch (event->type()) {
+    case QEvent::TouchBegin: {
+        if (handlePointerPress(window, pos, PointerType::Touch)) {
+            state.touchDragging = false;
+            return true;
+        }
+        // We own the whole touch sequence if it starts on the title bar, so no
+        // mouse events will be synthesized for it.
+        state.touchDragging = state.titleBarClicked;
+        return state.touchDragging;
+    }
+    case QEvent::TouchUpdate: {
+        if (!state.touchDragging) {
+            return false;
+        }
+        if ((pos - pressPos).manhattanLength() < QGuiApplication::styleHints()->startDragDistance()) {
+            return true;
+        }
+        state.touchDragging = false;
+        state.titleBarClicked = false;
+        state.lastTapTime.invalidate();
+        FRAMELESSHELPER_STATISTICS_INCREMENT(window, SystemMoves);
+        FRAMELESSHELPER_TRACE_SCOPE("startSystemMove");
+        if (!window->startSystemMove()) {
+            // ### FIXME: TO BE IMPLEMENTED!
+            qWarning() << "Current OS doesn't support QWindow::startSystemMove().";
+        }
+        return true;
+    }
+    case QEvent::TouchEnd: {
+        if (!state.touchDragging) {
+            return false;
+        }
+        state.touchDragging = false;
+        state.titleBarClicked = false;
+        // A tap which didn't move, check whether it completes a double tap.
+        if (checkDoubleTap(window, pos)) {
+            toggleMaximized(window);
+        }
+        return true;
+    }
+    case QEvent::TouchCancel: {
+        state.touchDragging = false;
+        state.titleBarClicked = false;
+        return false;
+    }
+    default:
+        break;
+    }
+    return false;
+}
+
+bool FramelessHelper::checkDoubleTap(QWindow *window, const QPoint &pos)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    PointerState &state = m_pointerStates[window];
+    const QStyleHints *styleHints = QGuiApplication::styleHints();
+    const bool doubleTap = (state.lastTapTime.isValid()
+            && (state.lastTapTime.elapsed() <= styleHints->mouseDoubleClickInterval())
+            && ((pos - state.lastTapPos).manhattanLength() <= styleHints->startDragDistance()));
+    if (doubleTap) {
+        state.lastTapTime.invalidate();
+    } else {
+        state.lastTapTime.start();
+        state.lastTapPos = pos;
+    }
+    return doubleTap;
 }
 
 bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
@@ -69,138 +613,127 @@ bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
     if (!object->isWindowType()) {
         return false;
     }
+    const auto window = qobject_cast<QWindow *>(object);
+    FRAMELESSHELPER_STATISTICS_INCREMENT(window, EventsFiltered);
+    FRAMELESSHELPER_STATISTICS_LATENCY(EventFilter);
     const QEvent::Type type = event->type();
-    // We are only interested in mouse events.
-    if ((type != QEvent::MouseButtonDblClick) && (type != QEvent::MouseButtonPress)
-            && (type != QEvent::MouseMove)) {
+    switch (type) {
+    case QEvent::Resize:
+    case QEvent::WindowStateChange: {
+        scheduleWindowMaskUpdate(window);
+        return false;
+    }
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+    case QEvent::TouchCancel:
+        return handleTouchEvent(window, static_cast<QTouchEvent *>(event));
+    case QEvent::TabletPress:
+    case QEvent::TabletMove:
+    case QEvent::TabletRelease: {
+        const auto tabletEvent = static_cast<QTabletEvent *>(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        const QPoint pos = tabletEvent->position().toPoint();
+#else
+        const QPoint pos = tabletEvent->posF().toPoint();
+#endif
+        if (type == QEvent::TabletMove) {
+            if (FramelessWindowsManager::getInputCoalescing(window)) {
+                coalescePointerMove(window, pos, tabletEvent->buttons(), PointerType::Pen);
+            } else {
+                handlePointerMove(window, pos, tabletEvent->buttons(), PointerType::Pen);
+            }
+            return false;
+        }
+        flushPendingPointerMove(window);
+        if (type == QEvent::TabletPress) {
+            if (handlePointerPress(window, pos, PointerType::Pen)) {
+                m_pointerStates[window].lastTapTime.invalidate();
+            } else if (m_pointerStates[window].titleBarClicked && (tabletEvent->button() == Qt::LeftButton)
+                       && checkDoubleTap(window, pos)) {
+                // The mouse events Qt or the system synthesizes for the pen are
+                // skipped below, so the double click has to be detected here.
+                toggleMaximized(window);
+            }
+        }
+        return false;
+    }
+    case QEvent::FocusOut:
+    case QEvent::Hide: {
+        // The grabs are lost as well, nothing would end the outline resize anymore.
+        if (m_outlineResize.window == window) {
+            stopOutlineResize(false);
+        }
+        return false;
+    }
+    case QEvent::KeyPress: {
+        if ((m_outlineResize.window == window)
+                && (static_cast<QKeyEvent *>(event)->key() == Qt::Key_Escape)) {
+            stopOutlineResize(false);
+            return true;
+        }
+        return false;
+    }
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+        break;
+    default:
+        // We are only interested in pointer events.
         return false;
     }
-    const auto window = qobject_cast<QWindow *>(object);
-    const int resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(window);
-    const int titleBarHeight = FramelessWindowsManager::getTitleBarHeight(window);
-    const bool resizable = FramelessWindowsManager::getResizable(window);
-    const int windowWidth = window->width();
     const auto mouseEvent = static_cast<QMouseEvent *>(event);
+    // Touch and tablet input is handled natively above, don't process it twice.
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QInputDevice *device = mouseEvent->device();
+    if (device && (device->type() != QInputDevice::DeviceType::Mouse)
+            && (device->type() != QInputDevice::DeviceType::TouchPad)) {
+        return false;
+    }
     const QPoint localMousePosition = mouseEvent->position().toPoint();
 #else
+    const Qt::MouseEventSource source = mouseEvent->source();
+    if ((source == Qt::MouseEventSynthesizedByQt) || (source == Qt::MouseEventSynthesizedBySystem)) {
+        return false;
+    }
     const QPoint localMousePosition = mouseEvent->windowPos().toPoint();
 #endif
-    const Qt::Edges edges = [window, resizeBorderThickness, windowWidth, &localMousePosition] {
-        const int windowHeight = window->height();
-        if (localMousePosition.y() <= resizeBorderThickness) {
-            if (localMousePosition.x() <= resizeBorderThickness) {
-                return Qt::TopEdge | Qt::LeftEdge;
-            }
-            if (localMousePosition.x() >= (windowWidth - resizeBorderThickness)) {
-                return Qt::TopEdge | Qt::RightEdge;
-            }
-            return Qt::Edges{Qt::TopEdge};
+    if (m_outlineResize.window == window) {
+        // The window keeps its size until the button is released, the pointer
+        // only drives the outline in the meantime.
+        if (type == QEvent::MouseMove) {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+            updateOutlineResize(mouseEvent->globalPosition().toPoint());
+#else
+            updateOutlineResize(mouseEvent->globalPos());
+#endif
+        } else if (type == QEvent::MouseButtonRelease) {
+            stopOutlineResize(true);
         }
-        if (localMousePosition.y() >= (windowHeight - resizeBorderThickness)) {
-            if (localMousePosition.x() <= resizeBorderThickness) {
-                return Qt::BottomEdge | Qt::LeftEdge;
-            }
-            if (localMousePosition.x() >= (windowWidth - resizeBorderThickness)) {
-                return Qt::BottomEdge | Qt::RightEdge;
-            }
-            return Qt::Edges{Qt::BottomEdge};
-        }
-        if (localMousePosition.x() <= resizeBorderThickness) {
-            return Qt::Edges{Qt::LeftEdge};
-        }
-        if (localMousePosition.x() >= (windowWidth - resizeBorderThickness)) {
-            return Qt::Edges{Qt::RightEdge};
-        }
-        return Qt::Edges{};
-    } ();
-    const bool hitTestVisible = Utilities::isHitTestVisible(window);
-    bool isInTitlebarArea = false;
-    if ((window->windowState() == Qt::WindowMaximized)
-            || (window->windowState() == Qt::WindowFullScreen)) {
-        isInTitlebarArea = (localMousePosition.y() >= 0)
-                && (localMousePosition.y() <= titleBarHeight)
-                && (localMousePosition.x() >= 0)
-                && (localMousePosition.x() <= windowWidth)
-                && !hitTestVisible;
-    }
-    if (window->windowState() == Qt::WindowNoState) {
-        isInTitlebarArea = (localMousePosition.y() > resizeBorderThickness)
-                && (localMousePosition.y() <= titleBarHeight)
-                && (localMousePosition.x() > resizeBorderThickness)
-                && (localMousePosition.x() < (windowWidth - resizeBorderThickness))
-                && !hitTestVisible;
-    }
-
-    // Determine if the mouse click occurred in the title bar
-    static bool titlebarClicked = false;
-    if (type == QEvent::MouseButtonPress) {
-        if (isInTitlebarArea)
-            titlebarClicked = true;
-        else
-            titlebarClicked = false;
+        return true;
     }
-
-    if (type == QEvent::MouseButtonDblClick) {
+    if (type == QEvent::MouseMove) {
+        if (FramelessWindowsManager::getInputCoalescing(window)) {
+            coalescePointerMove(window, localMousePosition, mouseEvent->buttons(), PointerType::Mouse);
+        } else {
+            handlePointerMove(window, localMousePosition, mouseEvent->buttons(), PointerType::Mouse);
+        }
+        return false;
+    }
+    // Button events are never delayed, but the motion we have been holding back
+    // must be processed before them to keep the original order.
+    flushPendingPointerMove(window);
+    if (type == QEvent::MouseButtonPress) {
+        handlePointerPress(window, localMousePosition, PointerType::Mouse);
+    } else if (type == QEvent::MouseButtonDblClick) {
         if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
             return false;
         }
-        if (isInTitlebarArea) {
-            if (window->windowState() == Qt::WindowState::WindowFullScreen) {
-                return false;
-            }
-            if (window->windowState() == Qt::WindowState::WindowMaximized) {
-                window->showNormal();
-            } else {
-                window->showMaximized();
-            }
-            window->setCursor(Qt::ArrowCursor);
-        }
-    } else if (type == QEvent::MouseMove) {
-        // Display resize indicators
-        static bool cursorChanged = false;
-        if ((window->windowState() == Qt::WindowState::WindowNoState) && resizable) {
-            if (((edges & Qt::TopEdge) && (edges & Qt::LeftEdge))
-                    || ((edges & Qt::BottomEdge) && (edges & Qt::RightEdge))) {
-                window->setCursor(Qt::SizeFDiagCursor);
-                cursorChanged = true;
-            } else if (((edges & Qt::TopEdge) && (edges & Qt::RightEdge))
-                       || ((edges & Qt::BottomEdge) && (edges & Qt::LeftEdge))) {
-                window->setCursor(Qt::SizeBDiagCursor);
-                cursorChanged = true;
-            } else if ((edges & Qt::TopEdge) || (edges & Qt::BottomEdge)) {
-                window->setCursor(Qt::SizeVerCursor);
-                cursorChanged = true;
-            } else if ((edges & Qt::LeftEdge) || (edges & Qt::RightEdge)) {
-                window->setCursor(Qt::SizeHorCursor);
-                cursorChanged = true;
-            } else {
-                if (cursorChanged) {
-                    window->setCursor(Qt::ArrowCursor);
-                    cursorChanged = false;
-                }
-            }
-        }
-
-        if ((mouseEvent->buttons() & Qt::LeftButton) && titlebarClicked) {
-            if (edges == Qt::Edges{}) {
-                if (isInTitlebarArea) {
-                    if (!window->startSystemMove()) {
-                        // ### FIXME: TO BE IMPLEMENTED!
-                        qWarning() << "Current OS doesn't support QWindow::startSystemMove().";
-                    }
-                }
-            }
-        }
-
-    } else if (type == QEvent::MouseButtonPress) {
-        if (edges != Qt::Edges{}) {
-            if ((window->windowState() == Qt::WindowState::WindowNoState) && !hitTestVisible && resizable) {
-                if (!window->startSystemResize(edges)) {
-                    // ### FIXME: TO BE IMPLEMENTED!
-                    qWarning() << "Current OS doesn't support QWindow::startSystemResize().";
-                }
-            }
+        const int resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(window);
+        if (!Utilities::isHitTestVisible(window, localMousePosition)
+                && Utilities::isInsideTitleBar(window, localMousePosition, resizeBorderThickness)) {
+            toggleMaximized(window);
         }
     }
 
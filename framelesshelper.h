@@ -29,9 +29,14 @@
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
 
 #include <QtCore/qobject.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtGui/qwindow.h>
 
 QT_BEGIN_NAMESPACE
-QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_FORWARD_DECLARE_CLASS(QTouchEvent)
 QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -43,13 +48,78 @@ class FRAMELESSHELPER_API FramelessHelper : public QObject
 
 public:
     explicit FramelessHelper(QObject *parent = nullptr);
-    ~FramelessHelper() override = default;
+    ~FramelessHelper() override;
 
     void removeWindowFrame(QWindow *window);
     void bringBackWindowFrame(QWindow *window);
 
+    void updateWindowMask(QWindow *window);
+
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    enum class PointerType : int
+    {
+        Mouse = 0,
+        Pen,
+        Touch
+    };
+
+    [[nodiscard]] static int getResizeBorderThickness(const QWindow *window, const PointerType pointer);
+    static void toggleMaximized(QWindow *window);
+
+    void scheduleWindowMaskUpdate(QWindow *window);
+    void handlePointerMove(QWindow *window, const QPoint &pos, const Qt::MouseButtons buttons, const PointerType pointer);
+    bool handlePointerPress(QWindow *window, const QPoint &pos, const PointerType pointer);
+    void coalescePointerMove(QWindow *window, const QPoint &pos, const Qt::MouseButtons buttons, const PointerType pointer);
+    void flushPendingPointerMove(QWindow *window);
+    [[nodiscard]] bool handleTouchEvent(QWindow *window, QTouchEvent *event);
+    [[nodiscard]] bool checkDoubleTap(QWindow *window, const QPoint &pos);
+    [[nodiscard]] bool startOutlineResize(QWindow *window, const Qt::Edges edges, const QPoint &globalPos);
+    void updateOutlineResize(const QPoint &globalPos);
+    void stopOutlineResize(const bool apply);
+
+private:
+    struct MaskUpdate
+    {
+        QPointer<QWindow> window = nullptr;
+        bool pending = false;
+    };
+    struct PendingMotion
+    {
+        QPointer<QWindow> window = nullptr;
+        QPoint pos = {};
+        Qt::MouseButtons buttons = {};
+        PointerType pointer = PointerType::Mouse;
+        bool pending = false;
+        int timerId = 0;
+    };
+    // Each window is pressed, hovered and tapped on its own, the state of one
+    // window must never leak into the handling of another one.
+    struct PointerState
+    {
+        bool titleBarClicked = false;
+        bool cursorChanged = false;
+        bool touchDragging = false;
+        QElapsedTimer lastTapTime = {};
+        QPoint lastTapPos = {};
+        QMetaObject::Connection destroyedConnection = {};
+    };
+    struct OutlineResize
+    {
+        QPointer<QWindow> window = nullptr;
+        Qt::Edges edges = {};
+        QPoint pressPos = {};
+        QRect startGeometry = {};
+        QRect geometry = {};
+    };
+    QHash<int, MaskUpdate> m_maskUpdates = {};
+    QHash<QWindow *, PendingMotion> m_pendingMotions = {};
+    QHash<QWindow *, PointerState> m_pointerStates = {};
+    OutlineResize m_outlineResize = {};
+    QScopedPointer<QWindow> m_outlineWindow;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -1,5 +1,17 @@
 TEMPLATE = subdirs
 CONFIG -= ordered
-SUBDIRS += lib examples
-lib.file = lib.pro
-examples.depends += lib
+SUBDIRS += core examples
+core.file = lib.pro
+qtHaveModule(widgets) {
+    SUBDIRS += widgets
+    widgets.file = widgets.pro
+    widgets.depends += core
+    examples.depends += widgets
+}
+qtHaveModule(quick) {
+    SUBDIRS += quick
+    quick.file = quick.pro
+    quick.depends += core
+    examples.depends += quick
+}
+examples.depends += core
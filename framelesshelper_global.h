@@ -39,6 +39,30 @@
 #endif
 #endif
 
+#ifndef FRAMELESSHELPER_WIDGETS_API
+#ifdef FRAMELESSHELPER_STATIC
+#define FRAMELESSHELPER_WIDGETS_API
+#else
+#ifdef FRAMELESSHELPER_WIDGETS_BUILD_LIBRARY
+#define FRAMELESSHELPER_WIDGETS_API Q_DECL_EXPORT
+#else
+#define FRAMELESSHELPER_WIDGETS_API Q_DECL_IMPORT
+#endif
+#endif
+#endif
+
+#ifndef FRAMELESSHELPER_QUICK_API
+#ifdef FRAMELESSHELPER_STATIC
+#define FRAMELESSHELPER_QUICK_API
+#else
+#ifdef FRAMELESSHELPER_QUICK_BUILD_LIBRARY
+#define FRAMELESSHELPER_QUICK_API Q_DECL_EXPORT
+#else
+#define FRAMELESSHELPER_QUICK_API Q_DECL_IMPORT
+#endif
+#endif
+#endif
+
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINDOWS)
 #define Q_OS_WINDOWS
 #endif
@@ -100,7 +124,12 @@ namespace Constants
 [[maybe_unused]] constexpr char kCaptionHeightFlag[] = "_FRAMELESSHELPER_CAPTION_HEIGHT";
 [[maybe_unused]] constexpr char kTitleBarHeightFlag[] = "_FRAMELESSHELPER_TITLE_BAR_HEIGHT";
 [[maybe_unused]] constexpr char kHitTestVisibleFlag[] = "_FRAMELESSHELPER_HIT_TEST_VISIBLE";
+[[maybe_unused]] constexpr char kHitTestVisibleRectsFlag[] = "_FRAMELESSHELPER_HIT_TEST_VISIBLE_RECTS";
+[[maybe_unused]] constexpr char kHitTestTableFlag[] = "_FRAMELESSHELPER_HIT_TEST_TABLE";
 [[maybe_unused]] constexpr char kWindowFixedSizeFlag[] = "_FRAMELESSHELPER_WINDOW_FIXED_SIZE";
+[[maybe_unused]] constexpr char kCornerRadiusFlag[] = "_FRAMELESSHELPER_CORNER_RADIUS";
+[[maybe_unused]] constexpr char kInputCoalescingFlag[] = "_FRAMELESSHELPER_INPUT_COALESCING";
+[[maybe_unused]] constexpr char kOutlineResizeFlag[] = "_FRAMELESSHELPER_OUTLINE_RESIZE";
 
 }
 
@@ -121,4 +150,12 @@ enum class ColorizationArea : int
 };
 Q_ENUM_NS(ColorizationArea)
 
+enum class FramePacingMode : int
+{
+    Off = 0,
+    SleepToVBlank,
+    Deferred
+};
+Q_ENUM_NS(FramePacingMode)
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -34,6 +34,8 @@ QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
+class FramePacer;
+
 class FRAMELESSHELPER_API FramelessHelperWin : public QAbstractNativeEventFilter
 {
     Q_DISABLE_COPY_MOVE(FramelessHelperWin)
@@ -44,6 +46,9 @@ public:
 
     static void addFramelessWindow(QWindow *window);
     static void removeFramelessWindow(QWindow *window);
+    [[nodiscard]] static FramePacer *framePacer();
+    [[nodiscard]] static bool startMessageTrace(const QString &fileName);
+    static void stopMessageTrace();
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override;
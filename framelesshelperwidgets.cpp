@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesshelperwidgets.h"
+#include "framelesswindowsmanager.h"
+#include "utilities.h"
+#include <QtCore/qpointer.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qapplication.h>
+#include <QtWidgets/qmenu.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+// Only one menu is created for the whole application, it's re-targeted to the
+// window which requested it every time before it pops up.
+struct SystemMenuData
+{
+    [[nodiscard]] QMenu *menu() {
+        if (!m_menu.isNull()) {
+            return m_menu.data();
+        }
+        if (!qobject_cast<QApplication *>(QCoreApplication::instance())) {
+            return nullptr;
+        }
+        m_menu = new QMenu;
+        m_restoreAction = m_menu->addAction(QCoreApplication::translate("FramelessHelper", "&Restore"), [this](){
+            if (m_window) {
+                m_window->showNormal();
+            }
+        });
+        // No mouse button is held when the menu is closed, so the system has to
+        // let the user move or size the window with the arrow keys instead.
+        m_moveAction = m_menu->addAction(QCoreApplication::translate("FramelessHelper", "&Move"), [this](){
+            if (m_window && m_window->handle()) {
+                static_cast<void>(Utilities::startKeyboardMoveResize(m_window->winId(), false));
+            }
+        });
+        m_sizeAction = m_menu->addAction(QCoreApplication::translate("FramelessHelper", "&Size"), [this](){
+            if (m_window && m_window->handle()) {
+                static_cast<void>(Utilities::startKeyboardMoveResize(m_window->winId(), true));
+            }
+        });
+        m_minimizeAction = m_menu->addAction(QCoreApplication::translate("FramelessHelper", "Mi&nimize"), [this](){
+            if (m_window) {
+                m_window->showMinimized();
+            }
+        });
+        m_maximizeAction = m_menu->addAction(QCoreApplication::translate("FramelessHelper", "Ma&ximize"), [this](){
+            if (m_window) {
+                m_window->showMaximized();
+            }
+        });
+        m_menu->addSeparator();
+        m_menu->addAction(QCoreApplication::translate("FramelessHelper", "&Close"), [this](){
+            if (m_window) {
+                m_window->close();
+            }
+        });
+        // The menu must not outlive the QApplication instance.
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, [this](){
+            delete m_menu.data();
+        });
+        return m_menu.data();
+    }
+
+    [[nodiscard]] bool popup(QWindow *window, const QPoint &pos) {
+        Q_ASSERT(window);
+        if (!window) {
+            return false;
+        }
+        QMenu *m = menu();
+        if (!m) {
+            return false;
+        }
+        m_window = window;
+        const Qt::WindowState state = window->windowState();
+        const bool max = ((state == Qt::WindowMaximized) || (state == Qt::WindowFullScreen));
+        const bool resizable = FramelessWindowsManager::getResizable(window);
+        m_restoreAction->setEnabled(max);
+        // Hidden if the window manager can't do it, there's nothing to fall back to.
+        const bool keyboardMoveResize = Utilities::isKeyboardMoveResizeSupported();
+        m_moveAction->setVisible(keyboardMoveResize);
+        m_sizeAction->setVisible(keyboardMoveResize);
+        m_moveAction->setEnabled(!max);
+        m_sizeAction->setEnabled(!max && resizable);
+        m_minimizeAction->setEnabled(true);
+        m_maximizeAction->setEnabled(!max && resizable);
+        m->popup(pos);
+        return true;
+    }
+
+private:
+    QPointer<QMenu> m_menu = nullptr;
+    QPointer<QWindow> m_window = nullptr;
+    QAction *m_restoreAction = nullptr;
+    QAction *m_moveAction = nullptr;
+    QAction *m_sizeAction = nullptr;
+    QAction *m_minimizeAction = nullptr;
+    QAction *m_maximizeAction = nullptr;
+};
+
+Q_GLOBAL_STATIC(SystemMenuData, g_systemMenuData)
+#endif
+
+void FramelessHelperWidgets::initialize()
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    Utilities::setSystemMenuProvider([](QWindow *window, const QPoint &pos) -> bool {
+        return g_systemMenuData()->popup(window, pos);
+    });
+#endif
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesshittesttable.h"
+#include <QtCore/qvariant.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+HitTestTable::HitTestTable(QObject *parent) : QObject(parent) {}
+
+HitTestTable::~HitTestTable() = default;
+
+void HitTestTable::setShapes(const QList<QPolygonF> &shapes)
+{
+    QRectF bounds = {};
+    for (auto &&shape : qAsConst(shapes)) {
+        bounds |= shape.boundingRect();
+    }
+    QMutexLocker locker(&m_mutex);
+    m_shapes = shapes;
+    m_bounds = bounds;
+}
+
+bool HitTestTable::contains(const QPointF &pos) const
+{
+    QMutexLocker locker(&m_mutex);
+    // Most events are nowhere near any of the items.
+    if (!m_bounds.contains(pos)) {
+        return false;
+    }
+    for (auto &&shape : qAsConst(m_shapes)) {
+        if (shape.containsPoint(pos, Qt::OddEvenFill)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HitTestTable::addToWindow(QWindow *window, HitTestTable *table)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(table);
+    if (!window || !table) {
+        return;
+    }
+    auto tables = qvariant_cast<QObjectList>(window->property(Constants::kHitTestTableFlag));
+    if (tables.contains(table)) {
+        return;
+    }
+    tables.append(table);
+    window->setProperty(Constants::kHitTestTableFlag, QVariant::fromValue(tables));
+}
+
+void HitTestTable::removeFromWindow(QWindow *window, HitTestTable *table)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(table);
+    if (!window || !table) {
+        return;
+    }
+    auto tables = qvariant_cast<QObjectList>(window->property(Constants::kHitTestTableFlag));
+    if (!tables.removeOne(table)) {
+        return;
+    }
+    // Windows without any table don't pay for the lookup.
+    window->setProperty(Constants::kHitTestTableFlag, (tables.isEmpty() ? QVariant() : QVariant::fromValue(tables)));
+}
+
+bool HitTestTable::hasWindowTables(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    return window->property(Constants::kHitTestTableFlag).isValid();
+}
+
+bool HitTestTable::windowContains(const QWindow *window, const QPointF &pos)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    const auto tables = qvariant_cast<QObjectList>(window->property(Constants::kHitTestTableFlag));
+    for (auto &&object : qAsConst(tables)) {
+        const auto table = static_cast<const HitTestTable *>(object);
+        if (table && table->contains(pos)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
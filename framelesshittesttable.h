@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qobject.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qpolygon.h>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The scene-space shapes of some hit-test visible items of one window, computed once
+// per frame by whoever knows the item transforms, and queried for every input event.
+// A window may have several tables, one per owner, each owner only adds and removes
+// its own one.
+class FRAMELESSHELPER_API HitTestTable : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(HitTestTable)
+
+public:
+    explicit HitTestTable(QObject *parent = nullptr);
+    ~HitTestTable() override;
+
+    void setShapes(const QList<QPolygonF> &shapes);
+    [[nodiscard]] bool contains(const QPointF &pos) const;
+
+    static void addToWindow(QWindow *window, HitTestTable *table);
+    static void removeFromWindow(QWindow *window, HitTestTable *table);
+    [[nodiscard]] static bool hasWindowTables(const QWindow *window);
+    // Whether any of the tables of the window contains the position.
+    [[nodiscard]] static bool windowContains(const QWindow *window, const QPointF &pos);
+
+private:
+    // Written by the render thread, read by the GUI thread.
+    mutable QMutex m_mutex;
+    QList<QPolygonF> m_shapes = {};
+    QRectF m_bounds = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
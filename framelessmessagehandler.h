@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qpoint.h>
+#include "framelessmessageidset.h"
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class ShellStateCache;
+class FramePacer;
+class CaptionUpdateCoalescer;
+
+// The Win32 values, spelled out so that the message handling can be compiled and
+// exercised on every platform. Checked against the system headers on Win32.
+namespace NativeMessageId
+{
+
+[[maybe_unused]] constexpr quint32 kSetText = 0x000C;
+[[maybe_unused]] constexpr quint32 kSettingChange = 0x001A;
+[[maybe_unused]] constexpr quint32 kWindowPosChanging = 0x0046;
+[[maybe_unused]] constexpr quint32 kDisplayChange = 0x007E;
+[[maybe_unused]] constexpr quint32 kSetIcon = 0x0080;
+[[maybe_unused]] constexpr quint32 kNcCalcSize = 0x0083;
+[[maybe_unused]] constexpr quint32 kNcHitTest = 0x0084;
+[[maybe_unused]] constexpr quint32 kNcPaint = 0x0085;
+[[maybe_unused]] constexpr quint32 kNcActivate = 0x0086;
+[[maybe_unused]] constexpr quint32 kNcUahDrawCaption = 0x00AE;
+[[maybe_unused]] constexpr quint32 kNcUahDrawFrame = 0x00AF;
+
+}
+
+namespace NativeHitTestResult
+{
+
+[[maybe_unused]] constexpr qint64 kClient = 1;
+[[maybe_unused]] constexpr qint64 kCaption = 2;
+[[maybe_unused]] constexpr qint64 kLeft = 10;
+[[maybe_unused]] constexpr qint64 kRight = 11;
+[[maybe_unused]] constexpr qint64 kTop = 12;
+[[maybe_unused]] constexpr qint64 kTopLeft = 13;
+[[maybe_unused]] constexpr qint64 kTopRight = 14;
+[[maybe_unused]] constexpr qint64 kBottom = 15;
+[[maybe_unused]] constexpr qint64 kBottomLeft = 16;
+[[maybe_unused]] constexpr qint64 kBottomRight = 17;
+
+}
+
+// Every message handled by NativeMessageHandler::handleMessage(), the native
+// event filter drops everything else without looking any further.
+[[maybe_unused]] constexpr const MessageIdSet kHandledNativeMessages = {
+    NativeMessageId::kSettingChange,
+    NativeMessageId::kDisplayChange,
+    NativeMessageId::kNcCalcSize,
+    NativeMessageId::kNcUahDrawCaption,
+    NativeMessageId::kNcUahDrawFrame,
+    NativeMessageId::kNcPaint,
+    NativeMessageId::kNcActivate,
+    NativeMessageId::kNcHitTest,
+    NativeMessageId::kSetIcon,
+    NativeMessageId::kSetText,
+#if (QT_VERSION < QT_VERSION_CHECK(6, 2, 2))
+    NativeMessageId::kWindowPosChanging
+#endif
+};
+
+// Same layout as the Win32 RECT, the right and bottom edges are exclusive.
+struct NativeRect
+{
+    qint32 left = 0;
+    qint32 top = 0;
+    qint32 right = 0;
+    qint32 bottom = 0;
+};
+
+// A window message with the data its lParam points to already decoded.
+struct NativeMessage
+{
+    quintptr window = 0;
+    quint32 message = 0;
+    quint64 wParam = 0;
+    qint64 lParam = 0;
+    // WM_NCCALCSIZE: the proposed client rectangle, adjusted in place.
+    NativeRect *clientRect = nullptr;
+    // WM_WINDOWPOSCHANGING: the flags of the WINDOWPOS structure, adjusted in place.
+    quint32 *windowPosFlags = nullptr;
+};
+
+// The system calls the message handling depends on, the real implementation
+// forwards them to Win32 and reports their failures, the message handling just
+// leaves the message to the system then.
+class FRAMELESSHELPER_API NativeWindowApi
+{
+public:
+    explicit NativeWindowApi() = default;
+    virtual ~NativeWindowApi();
+
+    [[nodiscard]] virtual bool isMaximized(const quintptr window) const = 0;
+    [[nodiscard]] virtual bool getClientRect(const quintptr window, NativeRect *rect) const = 0;
+    [[nodiscard]] virtual bool screenToClient(const quintptr window, QPoint *pos) const = 0;
+    // An opaque handle of the nearest monitor (HMONITOR on Win32), 0 on failure.
+    [[nodiscard]] virtual quintptr monitorFromWindow(const quintptr window) const = 0;
+    [[nodiscard]] virtual qint64 defWindowProc(const quintptr window, const quint32 message, const quint64 wParam, const qint64 lParam) = 0;
+    // The GWL_STYLE value, 0 on failure.
+    [[nodiscard]] virtual qint64 getWindowStyle(const quintptr window) const = 0;
+    [[nodiscard]] virtual bool setWindowStyle(const quintptr window, const qint64 style) = 0;
+    [[nodiscard]] virtual bool isDwmCompositionAvailable() const = 0;
+
+private:
+    Q_DISABLE_COPY_MOVE(NativeWindowApi)
+};
+
+// What the message handling needs to know about the Qt side of one window.
+class FRAMELESSHELPER_API NativeWindowHost
+{
+public:
+    explicit NativeWindowHost() = default;
+    virtual ~NativeWindowHost();
+
+    // Only used to attribute the statistics, may be null.
+    [[nodiscard]] virtual const QWindow *window() const = 0;
+    [[nodiscard]] virtual Qt::WindowState windowState() const = 0;
+    // In device pixels.
+    [[nodiscard]] virtual int resizeBorderThickness() const = 0;
+    [[nodiscard]] virtual int titleBarHeight() const = 0;
+    [[nodiscard]] virtual bool isFixedSize() const = 0;
+    // Whether the cursor is above a hit-test-visible object in the title bar.
+    [[nodiscard]] virtual bool isHitTestVisible() const = 0;
+    // Windows which answer WM_NCHITTEST themselves, such as FramelessWindow.
+    [[nodiscard]] virtual bool hasOwnHitTest() const = 0;
+    // Schedule the next frame of the window, in milliseconds.
+    virtual void scheduleUpdate(const int delay) = 0;
+    // Refresh the frame of the windows whose caption update is due, in milliseconds.
+    virtual void scheduleCaptionUpdate(const int delay) = 0;
+
+private:
+    Q_DISABLE_COPY_MOVE(NativeWindowHost)
+};
+
+// The handling of the window messages of frameless windows, independent of the
+// platform it's compiled for: everything it asks the system goes through a
+// NativeWindowApi, so it can be driven by a mock, for example to replay a trace.
+class FRAMELESSHELPER_API NativeMessageHandler
+{
+    Q_DISABLE_COPY_MOVE(NativeMessageHandler)
+
+public:
+    // Doesn't take the ownership of anything.
+    explicit NativeMessageHandler(NativeWindowApi *api, ShellStateCache *shellStateCache,
+                                  FramePacer *framePacer, CaptionUpdateCoalescer *captionUpdateCoalescer);
+    ~NativeMessageHandler();
+
+    [[nodiscard]] static constexpr bool isHandledMessage(const quint32 message)
+    {
+        return kHandledNativeMessages.contains(message);
+    }
+
+    // Returns true if the message has been handled and "result" should be
+    // returned to the system.
+    [[nodiscard]] bool handleMessage(NativeWindowHost *host, const NativeMessage &message, qint64 *result);
+
+private:
+    NativeWindowApi *m_api = nullptr;
+    ShellStateCache *m_shellStateCache = nullptr;
+    FramePacer *m_framePacer = nullptr;
+    CaptionUpdateCoalescer *m_captionUpdateCoalescer = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
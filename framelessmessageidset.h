@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <initializer_list>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// A compile time set of window message IDs, answering "is this a message we care
+// about?" with a single bit test. Only the system defined messages (below WM_USER)
+// can be members, anything above is never contained.
+class MessageIdSet
+{
+public:
+    static constexpr quint32 kCapacity = 0x0400; // WM_USER
+
+    constexpr MessageIdSet(std::initializer_list<quint32> ids) noexcept
+    {
+        for (const quint32 id : ids) {
+            if (id < kCapacity) {
+                m_bits[id / 64] |= (quint64(1) << (id % 64));
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(const quint32 id) const noexcept
+    {
+        return ((id < kCapacity) && ((m_bits[id / 64] & (quint64(1) << (id % 64))) != 0));
+    }
+
+private:
+    quint64 m_bits[kCapacity / 64] = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
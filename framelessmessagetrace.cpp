@@ -0,0 +1,330 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessmessagetrace.h"
+#include <QtCore/qdebug.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qendian.h>
+#include "framelessframegeometry.h"
+#include <cstring>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr char kTraceMagic[] = {'F', 'H', 'M', 'T'};
+static constexpr quint32 kTraceVersion = 2;
+static constexpr int kHeaderSize = (sizeof(kTraceMagic) + sizeof(quint32));
+static constexpr int kRectSize = (4 * sizeof(qint32));
+static constexpr int kRecordSize = (sizeof(qint64) + sizeof(quint64) + sizeof(quint32) + sizeof(quint64)
+                                    + sizeof(qint64) + sizeof(quint8) + sizeof(qint64) + sizeof(qint64)
+                                    // The window environment.
+                                    + sizeof(quint32) + sizeof(quint8) + (6 * sizeof(qint32)) + sizeof(quint32)
+                                    // The decoded message data, the last one is the length of the text.
+                                    + (2 * kRectSize) + (2 * sizeof(quint32)) + sizeof(quint32));
+// Window titles are far shorter, anything longer is a corrupted trace.
+static constexpr quint32 kMaximumTextLength = 0x10000;
+
+static constexpr quint8 kMaximizedFlag = 0x01;
+static constexpr quint8 kFixedSizeFlag = 0x02;
+static constexpr quint8 kHitTestVisibleFlag = 0x04;
+static constexpr quint8 kOwnHitTestFlag = 0x08;
+static constexpr quint8 kDwmCompositionFlag = 0x10;
+
+template <typename T>
+static inline void appendValue(char *&cursor, const T value)
+{
+    qToLittleEndian<T>(value, cursor);
+    cursor += sizeof(T);
+}
+
+template <typename T>
+[[nodiscard]] static inline T takeValue(const char *&cursor)
+{
+    const T value = qFromLittleEndian<T>(cursor);
+    cursor += sizeof(T);
+    return value;
+}
+
+static inline void appendRect(char *&cursor, const NativeRect &rect)
+{
+    appendValue<qint32>(cursor, rect.left);
+    appendValue<qint32>(cursor, rect.top);
+    appendValue<qint32>(cursor, rect.right);
+    appendValue<qint32>(cursor, rect.bottom);
+}
+
+[[nodiscard]] static inline NativeRect takeRect(const char *&cursor)
+{
+    NativeRect rect = {};
+    rect.left = takeValue<qint32>(cursor);
+    rect.top = takeValue<qint32>(cursor);
+    rect.right = takeValue<qint32>(cursor);
+    rect.bottom = takeValue<qint32>(cursor);
+    return rect;
+}
+
+[[nodiscard]] static inline bool operator==(const NativeRect &lhs, const NativeRect &rhs)
+{
+    return ((lhs.left == rhs.left) && (lhs.top == rhs.top) && (lhs.right == rhs.right) && (lhs.bottom == rhs.bottom));
+}
+
+[[nodiscard]] static inline bool operator!=(const NativeRect &lhs, const NativeRect &rhs)
+{
+    return !(lhs == rhs);
+}
+
+MessageTraceWriter::MessageTraceWriter(QIODevice *device) : m_device(device)
+{
+    Q_ASSERT(device);
+    if (!device || !device->isWritable()) {
+        qWarning() << "The message trace device is not writable.";
+        return;
+    }
+    char header[kHeaderSize] = {};
+    memcpy(header, kTraceMagic, sizeof(kTraceMagic));
+    char *cursor = (header + sizeof(kTraceMagic));
+    appendValue<quint32>(cursor, kTraceVersion);
+    m_valid = (device->write(header, kHeaderSize) == kHeaderSize);
+}
+
+MessageTraceWriter::~MessageTraceWriter() = default;
+
+bool MessageTraceWriter::isValid() const
+{
+    return m_valid;
+}
+
+void MessageTraceWriter::write(const MessageTraceRecord &record)
+{
+    if (!m_valid) {
+        return;
+    }
+    char buffer[kRecordSize] = {};
+    char *cursor = buffer;
+    appendValue<qint64>(cursor, record.timestamp);
+    appendValue<quint64>(cursor, record.window);
+    appendValue<quint32>(cursor, record.message);
+    appendValue<quint64>(cursor, record.wParam);
+    appendValue<qint64>(cursor, record.lParam);
+    appendValue<quint8>(cursor, (record.handled ? 1 : 0));
+    appendValue<qint64>(cursor, record.result);
+    appendValue<qint64>(cursor, record.duration);
+    appendValue<quint32>(cursor, record.windowState);
+    quint8 flags = 0;
+    if (record.maximized) {
+        flags |= kMaximizedFlag;
+    }
+    if (record.fixedSize) {
+        flags |= kFixedSizeFlag;
+    }
+    if (record.hitTestVisible) {
+        flags |= kHitTestVisibleFlag;
+    }
+    if (record.ownHitTest) {
+        flags |= kOwnHitTestFlag;
+    }
+    if (record.dwmComposition) {
+        flags |= kDwmCompositionFlag;
+    }
+    appendValue<quint8>(cursor, flags);
+    appendValue<qint32>(cursor, record.clientX);
+    appendValue<qint32>(cursor, record.clientY);
+    appendValue<qint32>(cursor, record.clientWidth);
+    appendValue<qint32>(cursor, record.clientHeight);
+    appendValue<qint32>(cursor, record.resizeBorderThickness);
+    appendValue<qint32>(cursor, record.titleBarHeight);
+    appendValue<quint32>(cursor, record.autoHideTaskbarEdges);
+    appendRect(cursor, record.proposedRect);
+    appendRect(cursor, record.adjustedRect);
+    appendValue<quint32>(cursor, record.proposedWindowPosFlags);
+    appendValue<quint32>(cursor, record.adjustedWindowPosFlags);
+    const auto textLength = static_cast<quint32>(qMin<qint64>(record.text.size(), kMaximumTextLength));
+    appendValue<quint32>(cursor, textLength);
+    QByteArray text(int(textLength * sizeof(quint16)), Qt::Uninitialized);
+    char *textCursor = text.data();
+    for (quint32 i = 0; i != textLength; ++i) {
+        appendValue<quint16>(textCursor, record.text.at(int(i)).unicode());
+    }
+    if ((m_device->write(buffer, kRecordSize) != kRecordSize) || (m_device->write(text) != text.size())) {
+        qWarning() << "Failed to write the message trace:" << m_device->errorString();
+        m_valid = false;
+    }
+}
+
+MessageTraceReader::MessageTraceReader(QIODevice *device) : m_device(device)
+{
+    Q_ASSERT(device);
+    if (!device || !device->isReadable()) {
+        qWarning() << "The message trace device is not readable.";
+        return;
+    }
+    char header[kHeaderSize] = {};
+    if (device->read(header, kHeaderSize) != kHeaderSize) {
+        qWarning() << "The message trace is truncated.";
+        return;
+    }
+    if (memcmp(header, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+        qWarning() << "Not a message trace.";
+        return;
+    }
+    const char *cursor = (header + sizeof(kTraceMagic));
+    const auto version = takeValue<quint32>(cursor);
+    if (version != kTraceVersion) {
+        qWarning() << "Unsupported message trace version:" << version;
+        return;
+    }
+    m_valid = true;
+}
+
+MessageTraceReader::~MessageTraceReader() = default;
+
+bool MessageTraceReader::isValid() const
+{
+    return m_valid;
+}
+
+bool MessageTraceReader::read(MessageTraceRecord *record)
+{
+    Q_ASSERT(record);
+    if (!m_valid || !record) {
+        return false;
+    }
+    char buffer[kRecordSize] = {};
+    if (m_device->read(buffer, kRecordSize) != kRecordSize) {
+        return false;
+    }
+    const char *cursor = buffer;
+    record->timestamp = takeValue<qint64>(cursor);
+    record->window = takeValue<quint64>(cursor);
+    record->message = takeValue<quint32>(cursor);
+    record->wParam = takeValue<quint64>(cursor);
+    record->lParam = takeValue<qint64>(cursor);
+    record->handled = (takeValue<quint8>(cursor) != 0);
+    record->result = takeValue<qint64>(cursor);
+    record->duration = takeValue<qint64>(cursor);
+    record->windowState = takeValue<quint32>(cursor);
+    const auto flags = takeValue<quint8>(cursor);
+    record->maximized = (flags & kMaximizedFlag);
+    record->fixedSize = (flags & kFixedSizeFlag);
+    record->hitTestVisible = (flags & kHitTestVisibleFlag);
+    record->ownHitTest = (flags & kOwnHitTestFlag);
+    record->dwmComposition = (flags & kDwmCompositionFlag);
+    record->clientX = takeValue<qint32>(cursor);
+    record->clientY = takeValue<qint32>(cursor);
+    record->clientWidth = takeValue<qint32>(cursor);
+    record->clientHeight = takeValue<qint32>(cursor);
+    record->resizeBorderThickness = takeValue<qint32>(cursor);
+    record->titleBarHeight = takeValue<qint32>(cursor);
+    record->autoHideTaskbarEdges = takeValue<quint32>(cursor);
+    record->proposedRect = takeRect(cursor);
+    record->adjustedRect = takeRect(cursor);
+    record->proposedWindowPosFlags = takeValue<quint32>(cursor);
+    record->adjustedWindowPosFlags = takeValue<quint32>(cursor);
+    const auto textLength = takeValue<quint32>(cursor);
+    if (textLength > kMaximumTextLength) {
+        qWarning() << "The message trace is corrupted.";
+        m_valid = false;
+        return false;
+    }
+    const QByteArray text = m_device->read(textLength * sizeof(quint16));
+    if (text.size() != int(textLength * sizeof(quint16))) {
+        return false;
+    }
+    record->text.resize(int(textLength));
+    const char *textCursor = text.constData();
+    for (quint32 i = 0; i != textLength; ++i) {
+        record->text[int(i)] = QChar(takeValue<quint16>(textCursor));
+    }
+    return true;
+}
+
+void MessageTrace::captureEnvironment(const NativeWindowApi *api, const NativeWindowHost *host,
+                                      ShellStateCache *shellStateCache, const NativeMessage &message,
+                                      MessageTraceRecord *record)
+{
+    Q_ASSERT(api);
+    Q_ASSERT(host);
+    Q_ASSERT(shellStateCache);
+    Q_ASSERT(record);
+    if (!api || !host || !shellStateCache || !record) {
+        return;
+    }
+    record->window = message.window;
+    record->message = message.message;
+    record->wParam = message.wParam;
+    record->lParam = message.lParam;
+    record->windowState = host->windowState();
+    record->maximized = api->isMaximized(message.window);
+    record->fixedSize = host->isFixedSize();
+    record->hitTestVisible = host->isHitTestVisible();
+    record->ownHitTest = host->hasOwnHitTest();
+    record->dwmComposition = api->isDwmCompositionAvailable();
+    QPoint origin = {0, 0};
+    if (api->screenToClient(message.window, &origin)) {
+        record->clientX = -origin.x();
+        record->clientY = -origin.y();
+    }
+    NativeRect clientRect = {};
+    if (api->getClientRect(message.window, &clientRect)) {
+        record->clientWidth = (clientRect.right - clientRect.left);
+        record->clientHeight = (clientRect.bottom - clientRect.top);
+    }
+    record->resizeBorderThickness = host->resizeBorderThickness();
+    record->titleBarHeight = host->titleBarHeight();
+    const quintptr monitor = api->monitorFromWindow(message.window);
+    if (monitor) {
+        record->autoHideTaskbarEdges = static_cast<quint32>(int(shellStateCache->getAutoHideTaskbarEdges(monitor)));
+    }
+    if (message.clientRect) {
+        record->proposedRect = *message.clientRect;
+        record->adjustedRect = *message.clientRect;
+    }
+    if (message.windowPosFlags) {
+        record->proposedWindowPosFlags = *message.windowPosFlags;
+        record->adjustedWindowPosFlags = *message.windowPosFlags;
+    }
+}
+
+QList<MessageTraceStatistics> MessageTrace::summarize(MessageTraceReader *reader)
+{
+    Q_ASSERT(reader);
+    if (!reader || !reader->isValid()) {
+        return {};
+    }
+    QMap<quint32, MessageTraceStatistics> statistics = {};
+    MessageTraceRecord record = {};
+    while (reader->read(&record)) {
+        MessageTraceStatistics &entry = statistics[record.message];
+        entry.message = record.message;
+        ++entry.count;
+        if (record.handled) {
+            ++entry.handledCount;
+        }
+        entry.totalDuration += record.duration;
+        entry.maximumDuration = qMax(entry.maximumDuration, record.duration);
+    }
+    return statistics.values();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
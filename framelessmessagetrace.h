@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include "framelessmessagehandler.h"
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// One native message handled for a frameless window, as it has been seen by the
+// native event filter and what it answered.
+struct MessageTraceRecord
+{
+    // Since the recording started, in nanoseconds.
+    qint64 timestamp = 0;
+    quint64 window = 0;
+    quint32 message = 0;
+    quint64 wParam = 0;
+    qint64 lParam = 0;
+    bool handled = false;
+    qint64 result = 0;
+    // Time spent handling the message, in nanoseconds.
+    qint64 duration = 0;
+
+    // Everything the message handling asked about the window when the message
+    // arrived, so that the message can be replayed elsewhere.
+    quint32 windowState = Qt::WindowNoState;
+    bool maximized = false;
+    bool fixedSize = false;
+    bool hitTestVisible = false;
+    bool ownHitTest = false;
+    bool dwmComposition = false;
+    // The client area on the screen, in device pixels.
+    qint32 clientX = 0;
+    qint32 clientY = 0;
+    qint32 clientWidth = 0;
+    qint32 clientHeight = 0;
+    qint32 resizeBorderThickness = 0;
+    qint32 titleBarHeight = 0;
+    quint32 autoHideTaskbarEdges = 0;
+
+    // WM_NCCALCSIZE: the client rectangle proposed by the system and the one
+    // it has been adjusted to.
+    NativeRect proposedRect = {};
+    NativeRect adjustedRect = {};
+    // WM_WINDOWPOSCHANGING: the flags before and after the handling.
+    quint32 proposedWindowPosFlags = 0;
+    quint32 adjustedWindowPosFlags = 0;
+    // WM_SETTEXT: the new window title.
+    QString text = {};
+};
+
+struct MessageTraceStatistics
+{
+    quint32 message = 0;
+    quint64 count = 0;
+    quint64 handledCount = 0;
+    qint64 totalDuration = 0;
+    qint64 maximumDuration = 0;
+    // Replay only (tests/messagereplayer.h): how often the replayed answer differs
+    // from the recorded one.
+    quint64 mismatchCount = 0;
+};
+
+// A trace is a small header followed by little endian records, so it can be
+// written on Windows and analyzed anywhere. Each record is a fixed size part and
+// a length-prefixed UTF-16 payload (the text of WM_SETTEXT).
+class FRAMELESSHELPER_API MessageTraceWriter
+{
+    Q_DISABLE_COPY_MOVE(MessageTraceWriter)
+
+public:
+    explicit MessageTraceWriter(QIODevice *device);
+    ~MessageTraceWriter();
+
+    [[nodiscard]] bool isValid() const;
+    void write(const MessageTraceRecord &record);
+
+private:
+    QIODevice *m_device = nullptr;
+    bool m_valid = false;
+};
+
+class FRAMELESSHELPER_API MessageTraceReader
+{
+    Q_DISABLE_COPY_MOVE(MessageTraceReader)
+
+public:
+    explicit MessageTraceReader(QIODevice *device);
+    ~MessageTraceReader();
+
+    [[nodiscard]] bool isValid() const;
+    [[nodiscard]] bool read(MessageTraceRecord *record);
+
+private:
+    QIODevice *m_device = nullptr;
+    bool m_valid = false;
+};
+
+namespace MessageTrace
+{
+
+// Fills in the window environment of the record and the data the message points
+// to, asking the same interfaces the message handling asks.
+FRAMELESSHELPER_API void captureEnvironment(const NativeWindowApi *api, const NativeWindowHost *host,
+                                            ShellStateCache *shellStateCache, const NativeMessage &message,
+                                            MessageTraceRecord *record);
+
+// Reads the whole trace and reports the recorded latency per message type,
+// sorted by the message ID.
+[[nodiscard]] FRAMELESSHELPER_API QList<MessageTraceStatistics> summarize(MessageTraceReader *reader);
+
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -28,51 +28,191 @@
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
+struct FrameSnapshotData
+{
+    QHash<QQuickWindow *, QSharedPointer<FrameConfigurationSnapshot>> snapshots = {};
+};
+
+Q_GLOBAL_STATIC(FrameSnapshotData, g_frameSnapshotData)
+
 FramelessQuickHelper::FramelessQuickHelper(QQuickItem *parent) : QQuickItem(parent)
 {
+    // The notify signals are emitted for changes coming from bindings as well, so
+    // together with the setters, which handle the writes that don't change the
+    // value, this catches every value which has to reach the window.
+    connect(this, &FramelessQuickHelper::resizeBorderThicknessChanged, this, [this](){
+        writeToWindow(ResizeBorderThicknessBit);
+    });
+    connect(this, &FramelessQuickHelper::titleBarHeightChanged, this, [this](){
+        writeToWindow(TitleBarHeightBit);
+    });
+    connect(this, &FramelessQuickHelper::resizableChanged, this, [this](){
+        writeToWindow(ResizableBit);
+    });
+}
+
+FramelessQuickHelper::~FramelessQuickHelper()
+{
+    untrackTitleBarItem();
+    for (auto &&connection : qAsConst(m_hitTestVisibleItemConnections)) {
+        disconnect(connection);
+    }
+    QQuickWindow *win = window();
+    if (win) {
+        HitTestTable::removeFromWindow(win, &m_hitTestTable);
+    }
 }
 
 qreal FramelessQuickHelper::resizeBorderThickness() const
 {
-    return FramelessWindowsManager::getResizeBorderThickness(window());
+    return m_resizeBorderThickness;
 }
 
 void FramelessQuickHelper::setResizeBorderThickness(const qreal val)
 {
-    FramelessWindowsManager::setResizeBorderThickness(window(), qRound(val));
+    // An explicit write must reach the window even if it doesn't change the value,
+    // the window may still be using the system value.
+    const bool changed = !qFuzzyCompare(resizeBorderThickness(), val);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    m_resizeBorderThickness = val;
+    if (!changed) {
+        writeToWindow(ResizeBorderThicknessBit);
+    }
+#else
+    if (!changed) {
+        writeToWindow(ResizeBorderThicknessBit);
+        return;
+    }
+    m_resizeBorderThickness = val;
     Q_EMIT resizeBorderThicknessChanged(val);
+#endif
 }
 
 qreal FramelessQuickHelper::titleBarHeight() const
 {
-    return FramelessWindowsManager::getTitleBarHeight(window());
+    return m_titleBarHeight;
 }
 
 void FramelessQuickHelper::setTitleBarHeight(const qreal val)
 {
-    FramelessWindowsManager::setTitleBarHeight(window(), qRound(val));
+    const bool changed = !qFuzzyCompare(titleBarHeight(), val);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    m_titleBarHeight = val;
+    if (!changed) {
+        writeToWindow(TitleBarHeightBit);
+    }
+#else
+    if (!changed) {
+        writeToWindow(TitleBarHeightBit);
+        return;
+    }
+    m_titleBarHeight = val;
     Q_EMIT titleBarHeightChanged(val);
+#endif
 }
 
 bool FramelessQuickHelper::resizable() const
 {
-    return FramelessWindowsManager::getResizable(window());
+    return m_resizable;
 }
 
 void FramelessQuickHelper::setResizable(const bool val)
 {
-    FramelessWindowsManager::setResizable(window(), val);
+    const bool changed = (resizable() != val);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    m_resizable = val;
+    if (!changed) {
+        writeToWindow(ResizableBit);
+    }
+#else
+    if (!changed) {
+        writeToWindow(ResizableBit);
+        return;
+    }
+    m_resizable = val;
     Q_EMIT resizableChanged(val);
+#endif
+}
+
+QQuickItem *FramelessQuickHelper::titleBarItem() const
+{
+    return m_titleBarItem;
+}
+
+void FramelessQuickHelper::setTitleBarItem(QQuickItem *item)
+{
+    if (m_titleBarItem == item) {
+        return;
+    }
+    untrackTitleBarItem();
+    m_titleBarItem = item;
+    if (m_titleBarItem) {
+        trackTitleBarItem();
+        publishTitleBarHeight();
+    }
+    Q_EMIT titleBarItemChanged();
+}
+
+QQmlListProperty<QQuickItem> FramelessQuickHelper::hitTestVisibleItems()
+{
+    return QQmlListProperty<QQuickItem>(this, nullptr,
+                                        &FramelessQuickHelper::appendHitTestVisibleItem,
+                                        &FramelessQuickHelper::hitTestVisibleItemCount,
+                                        &FramelessQuickHelper::hitTestVisibleItemAt,
+                                        &FramelessQuickHelper::clearHitTestVisibleItems);
+}
+
+QSharedPointer<const FrameConfigurationSnapshot> FramelessQuickHelper::frameConfigurationSnapshot(QQuickWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    const auto it = g_frameSnapshotData()->snapshots.constFind(window);
+    if (it != g_frameSnapshotData()->snapshots.constEnd()) {
+        return it.value();
+    }
+    const auto snapshot = QSharedPointer<FrameConfigurationSnapshot>::create();
+    snapshot->update(window);
+    // Emitted on the render thread while the GUI thread is blocked, so the window
+    // can be queried safely, and the items will see the values of the coming frame.
+    QObject::connect(window, &QQuickWindow::beforeSynchronizing, window, [window, snapshot](){
+        snapshot->update(window);
+    }, Qt::DirectConnection);
+    QObject::connect(window, &QObject::destroyed, [window](){
+        g_frameSnapshotData()->snapshots.remove(window);
+    });
+    g_frameSnapshotData()->snapshots.insert(window, snapshot);
+    return snapshot;
 }
 
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+QBindable<qreal> FramelessQuickHelper::bindableResizeBorderThickness()
+{
+    return &m_resizeBorderThickness;
+}
+
+QBindable<qreal> FramelessQuickHelper::bindableTitleBarHeight()
+{
+    return &m_titleBarHeight;
+}
+
+QBindable<bool> FramelessQuickHelper::bindableResizable()
+{
+    return &m_resizable;
+}
+#endif
+
 void FramelessQuickHelper::removeWindowFrame()
 {
     FramelessWindowsManager::addWindow(window());
+    updatePropertiesFromWindow();
 }
 
 void FramelessQuickHelper::bringBackWindowFrame()
 {
     FramelessWindowsManager::removeWindow(window());
+    updatePropertiesFromWindow();
 }
 
 bool FramelessQuickHelper::isWindowFrameless() const
@@ -86,7 +226,282 @@ void FramelessQuickHelper::setHitTestVisible(QQuickItem *item, const bool visibl
     if (!item) {
         return;
     }
-    FramelessWindowsManager::setHitTestVisible(window(), item, visible);
+    // Handled by our own per-frame table instead of the window property, the table
+    // knows about the item transforms.
+    const bool changed = (visible ? !m_hitTestVisibleItems.contains(item) : m_hitTestVisibleItems.contains(item));
+    if (!changed) {
+        return;
+    }
+    if (visible) {
+        addHitTestVisibleItem(item);
+    } else {
+        removeHitTestVisibleItem(item);
+    }
+    Q_EMIT hitTestVisibleItemsChanged();
+}
+
+void FramelessQuickHelper::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemSceneChange) {
+        QQuickWindow *oldWindow = window();
+        if (oldWindow && (oldWindow != value.window)) {
+            HitTestTable::removeFromWindow(oldWindow, &m_hitTestTable);
+        }
+    }
+    QQuickItem::itemChange(change, value);
+    if (change == ItemSceneChange) {
+        updateWindowConnections(value.window);
+    }
+}
+
+void FramelessQuickHelper::writeToWindow(const quint8 property)
+{
+    if (m_updatingFromWindow) {
+        return;
+    }
+    QQuickWindow *win = window();
+    if (!win) {
+        // Applied once we get a window.
+        m_pendingWrites |= property;
+        return;
+    }
+    switch (property) {
+    case ResizeBorderThicknessBit:
+        FramelessWindowsManager::setResizeBorderThickness(win, qRound(resizeBorderThickness()));
+        break;
+    case TitleBarHeightBit:
+        FramelessWindowsManager::setTitleBarHeight(win, qRound(titleBarHeight()));
+        break;
+    case ResizableBit:
+        FramelessWindowsManager::setResizable(win, resizable());
+        break;
+    default:
+        break;
+    }
+}
+
+void FramelessQuickHelper::updateWindowConnections(QQuickWindow *window)
+{
+    for (auto &&connection : qAsConst(m_windowConnections)) {
+        disconnect(connection);
+    }
+    m_windowConnections.clear();
+    if (!window) {
+        return;
+    }
+    // The resolved values depend on the DPI of the current screen and on the window
+    // state, the bindings will only be re-evaluated if anything really changed.
+    m_windowConnections.append(connect(window, &QWindow::screenChanged, this, &FramelessQuickHelper::updatePropertiesFromWindow));
+    m_windowConnections.append(connect(window, &QWindow::windowStateChanged, this, &FramelessQuickHelper::updatePropertiesFromWindow));
+    // Values assigned before we got a window haven't reached it yet.
+    if (m_pendingWrites & ResizeBorderThicknessBit) {
+        FramelessWindowsManager::setResizeBorderThickness(window, qRound(resizeBorderThickness()));
+    }
+    if (m_pendingWrites & TitleBarHeightBit) {
+        FramelessWindowsManager::setTitleBarHeight(window, qRound(titleBarHeight()));
+    }
+    if (m_pendingWrites & ResizableBit) {
+        FramelessWindowsManager::setResizable(window, resizable());
+    }
+    m_pendingWrites = 0;
+    // Emitted while the GUI thread is blocked and after all the items have been
+    // polished, so the transforms are both stable and final for the coming frame.
+    m_windowConnections.append(connect(window, &QQuickWindow::beforeSynchronizing, this,
+                                       &FramelessQuickHelper::updateHitTestTable, Qt::DirectConnection));
+    m_hitTestTable.setShapes({});
+    // The other helpers of the window keep their own tables.
+    HitTestTable::addToWindow(window, &m_hitTestTable);
+    window->update();
+    // The scene coordinates may be different in the new window.
+    m_titleBarRect = {};
+    updateTitleBarRect();
+    // Pick up what the new window resolves the properties to.
+    updatePropertiesFromWindow();
+}
+
+void FramelessQuickHelper::updatePropertiesFromWindow()
+{
+    const QQuickWindow *win = window();
+    if (!win) {
+        return;
+    }
+    m_updatingFromWindow = true;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    // Don't break the bindings, they are the source of truth in this case.
+    if (!m_resizeBorderThickness.hasBinding()) {
+        m_resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(win);
+    }
+    if (!m_titleBarHeight.hasBinding()) {
+        m_titleBarHeight = FramelessWindowsManager::getTitleBarHeight(win);
+    }
+    if (!m_resizable.hasBinding()) {
+        m_resizable = FramelessWindowsManager::getResizable(win);
+    }
+#else
+    setResizeBorderThickness(FramelessWindowsManager::getResizeBorderThickness(win));
+    setTitleBarHeight(FramelessWindowsManager::getTitleBarHeight(win));
+    setResizable(FramelessWindowsManager::getResizable(win));
+#endif
+    m_updatingFromWindow = false;
+}
+
+void FramelessQuickHelper::trackTitleBarItem()
+{
+    QQuickItem *item = m_titleBarItem;
+    if (!item) {
+        return;
+    }
+    const auto update = [this](){
+        updateTitleBarRect();
+    };
+    const auto retrack = [this](){
+        // The chain of ancestors has changed, observe the new one instead.
+        untrackTitleBarItem();
+        trackTitleBarItem();
+    };
+    // Moving or hiding any of the ancestors affects the item as well, so we observe
+    // the whole chain instead of walking it each time the window is hit-tested.
+    for (QQuickItem *it = item; it; it = it->parentItem()) {
+        m_titleBarConnections.append(connect(it, &QQuickItem::xChanged, this, update));
+        m_titleBarConnections.append(connect(it, &QQuickItem::yChanged, this, update));
+        m_titleBarConnections.append(connect(it, &QQuickItem::widthChanged, this, update));
+        m_titleBarConnections.append(connect(it, &QQuickItem::heightChanged, this, update));
+        m_titleBarConnections.append(connect(it, &QQuickItem::visibleChanged, this, update));
+        m_titleBarConnections.append(connect(it, &QQuickItem::parentChanged, this, retrack));
+    }
+    m_titleBarConnections.append(connect(item, &QObject::destroyed, this, [this](){
+        untrackTitleBarItem();
+        m_titleBarItem = nullptr;
+        Q_EMIT titleBarItemChanged();
+    }));
+    updateTitleBarRect();
+}
+
+void FramelessQuickHelper::untrackTitleBarItem()
+{
+    for (auto &&connection : qAsConst(m_titleBarConnections)) {
+        disconnect(connection);
+    }
+    m_titleBarConnections.clear();
+    m_titleBarRect = {};
+}
+
+void FramelessQuickHelper::updateTitleBarRect()
+{
+    if (!m_titleBarItem) {
+        return;
+    }
+    const QRect rect = (m_titleBarItem->isVisible()
+                        ? m_titleBarItem->mapRectToScene(m_titleBarItem->boundingRect()).toAlignedRect() : QRect{});
+    if (m_titleBarRect == rect) {
+        return;
+    }
+    m_titleBarRect = rect;
+    publishTitleBarHeight();
+}
+
+void FramelessQuickHelper::publishTitleBarHeight()
+{
+    QQuickWindow *win = window();
+    if (!win || !m_titleBarItem || m_titleBarRect.isEmpty()) {
+        return;
+    }
+    // The title bar is always at the top of the window, only its bottom matters.
+    FramelessWindowsManager::setTitleBarHeight(win, m_titleBarRect.y() + m_titleBarRect.height());
+    updatePropertiesFromWindow();
+}
+
+void FramelessQuickHelper::addHitTestVisibleItem(QQuickItem *item)
+{
+    Q_ASSERT(item);
+    if (!item || m_hitTestVisibleItems.contains(item)) {
+        return;
+    }
+    m_hitTestVisibleItems.append(item);
+    m_hitTestVisibleItemConnections.insert(item, connect(item, &QObject::destroyed, this, [this, item](){
+        removeHitTestVisibleItem(item);
+        Q_EMIT hitTestVisibleItemsChanged();
+    }));
+    QQuickWindow *win = window();
+    if (win) {
+        win->update();
+    }
+}
+
+void FramelessQuickHelper::removeHitTestVisibleItem(QQuickItem *item)
+{
+    Q_ASSERT(item);
+    if (!item || !m_hitTestVisibleItems.removeOne(item)) {
+        return;
+    }
+    disconnect(m_hitTestVisibleItemConnections.take(item));
+    QQuickWindow *win = window();
+    if (win) {
+        win->update();
+    }
+}
+
+void FramelessQuickHelper::updateHitTestTable()
+{
+    // Runs on the render thread, but the GUI thread is blocked meanwhile.
+    const QQuickWindow *win = window();
+    QList<QPolygonF> shapes = {};
+    for (auto &&item : qAsConst(m_hitTestVisibleItems)) {
+        if (!item->isVisible() || (item->window() != win)) {
+            continue;
+        }
+        const auto sceneShape = [](const QQuickItem *it) -> QPolygonF {
+            const QRectF rect = it->boundingRect();
+            return QPolygonF({it->mapToScene(rect.topLeft()), it->mapToScene(rect.topRight()),
+                              it->mapToScene(rect.bottomRight()), it->mapToScene(rect.bottomLeft())});
+        };
+        // Rotated and scaled items are no longer axis-aligned rectangles.
+        QPolygonF shape = sceneShape(item);
+        // Parts which have been scrolled out of a Flickable (or any other clipping
+        // ancestor) are invisible and must not block the title bar.
+        for (const QQuickItem *parent = item->parentItem(); parent; parent = parent->parentItem()) {
+            if (parent->clip()) {
+                shape = shape.intersected(sceneShape(parent));
+            }
+        }
+        if (!shape.isEmpty()) {
+            shapes.append(shape);
+        }
+    }
+    m_hitTestTable.setShapes(shapes);
+}
+
+void FramelessQuickHelper::appendHitTestVisibleItem(QQmlListProperty<QQuickItem> *list, QQuickItem *item)
+{
+    const auto helper = static_cast<FramelessQuickHelper *>(list->object);
+    if (!item || helper->m_hitTestVisibleItems.contains(item)) {
+        return;
+    }
+    helper->addHitTestVisibleItem(item);
+    Q_EMIT helper->hitTestVisibleItemsChanged();
+}
+
+FramelessQuickHelper::ListSizeType FramelessQuickHelper::hitTestVisibleItemCount(QQmlListProperty<QQuickItem> *list)
+{
+    return static_cast<FramelessQuickHelper *>(list->object)->m_hitTestVisibleItems.size();
+}
+
+QQuickItem *FramelessQuickHelper::hitTestVisibleItemAt(QQmlListProperty<QQuickItem> *list, ListSizeType index)
+{
+    return static_cast<FramelessQuickHelper *>(list->object)->m_hitTestVisibleItems.value(index);
+}
+
+void FramelessQuickHelper::clearHitTestVisibleItems(QQmlListProperty<QQuickItem> *list)
+{
+    const auto helper = static_cast<FramelessQuickHelper *>(list->object);
+    if (helper->m_hitTestVisibleItems.isEmpty()) {
+        return;
+    }
+    const QList<QQuickItem *> items = helper->m_hitTestVisibleItems;
+    for (auto &&item : qAsConst(items)) {
+        helper->removeHitTestVisibleItem(item);
+    }
+    Q_EMIT helper->hitTestVisibleItemsChanged();
 }
 
 FRAMELESSHELPER_END_NAMESPACE
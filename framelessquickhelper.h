@@ -25,24 +25,41 @@
 #pragma once
 
 #include "framelesshelper_global.h"
+#include "framelessframesnapshot.h"
+#include "framelesshittesttable.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtQml/qqml.h>
+#include <QtQml/qqmllist.h>
 #include <QtQuick/qquickitem.h>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#include <QtCore/qproperty.h>
+#endif
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
-class FRAMELESSHELPER_API FramelessQuickHelper : public QQuickItem
+class FRAMELESSHELPER_QUICK_API FramelessQuickHelper : public QQuickItem
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(FramelessQuickHelper)
 #ifdef QML_NAMED_ELEMENT
     QML_NAMED_ELEMENT(FramelessHelper)
 #endif
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    Q_PROPERTY(qreal resizeBorderThickness READ resizeBorderThickness WRITE setResizeBorderThickness NOTIFY resizeBorderThicknessChanged BINDABLE bindableResizeBorderThickness)
+    Q_PROPERTY(qreal titleBarHeight READ titleBarHeight WRITE setTitleBarHeight NOTIFY titleBarHeightChanged BINDABLE bindableTitleBarHeight)
+    Q_PROPERTY(bool resizable READ resizable WRITE setResizable NOTIFY resizableChanged BINDABLE bindableResizable)
+#else
     Q_PROPERTY(qreal resizeBorderThickness READ resizeBorderThickness WRITE setResizeBorderThickness NOTIFY resizeBorderThicknessChanged)
     Q_PROPERTY(qreal titleBarHeight READ titleBarHeight WRITE setTitleBarHeight NOTIFY titleBarHeightChanged)
     Q_PROPERTY(bool resizable READ resizable WRITE setResizable NOTIFY resizableChanged)
+#endif
+    Q_PROPERTY(QQuickItem* titleBarItem READ titleBarItem WRITE setTitleBarItem NOTIFY titleBarItemChanged)
+    Q_PROPERTY(QQmlListProperty<QQuickItem> hitTestVisibleItems READ hitTestVisibleItems NOTIFY hitTestVisibleItemsChanged)
 
 public:
     explicit FramelessQuickHelper(QQuickItem *parent = nullptr);
-    ~FramelessQuickHelper() override = default;
+    ~FramelessQuickHelper() override;
 
     Q_NODISCARD qreal resizeBorderThickness() const;
     void setResizeBorderThickness(const qreal val);
@@ -53,6 +70,21 @@ public:
     Q_NODISCARD bool resizable() const;
     void setResizable(const bool val);
 
+    Q_NODISCARD QQuickItem *titleBarItem() const;
+    void setTitleBarItem(QQuickItem *item);
+
+    Q_NODISCARD QQmlListProperty<QQuickItem> hitTestVisibleItems();
+
+    // To be acquired on the GUI thread, the snapshot itself can then be read from
+    // any thread, e.g. in QQuickItem::updatePaintNode() on the render thread.
+    Q_NODISCARD static QSharedPointer<const FrameConfigurationSnapshot> frameConfigurationSnapshot(QQuickWindow *window);
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    Q_NODISCARD QBindable<qreal> bindableResizeBorderThickness();
+    Q_NODISCARD QBindable<qreal> bindableTitleBarHeight();
+    Q_NODISCARD QBindable<bool> bindableResizable();
+#endif
+
 public Q_SLOTS:
     void removeWindowFrame();
     void bringBackWindowFrame();
@@ -63,6 +95,64 @@ Q_SIGNALS:
     void resizeBorderThicknessChanged(qreal);
     void titleBarHeightChanged(qreal);
     void resizableChanged(bool);
+    void titleBarItemChanged();
+    void hitTestVisibleItemsChanged();
+
+protected:
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
+private:
+    enum : quint8
+    {
+        ResizeBorderThicknessBit = 0x01,
+        TitleBarHeightBit = 0x02,
+        ResizableBit = 0x04
+    };
+
+    void writeToWindow(const quint8 property);
+    void updateWindowConnections(QQuickWindow *window);
+    void updatePropertiesFromWindow();
+
+    void trackTitleBarItem();
+    void untrackTitleBarItem();
+    void updateTitleBarRect();
+    void publishTitleBarHeight();
+    void addHitTestVisibleItem(QQuickItem *item);
+    void removeHitTestVisibleItem(QQuickItem *item);
+    void updateHitTestTable();
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    using ListSizeType = qsizetype;
+#else
+    using ListSizeType = int;
+#endif
+    static void appendHitTestVisibleItem(QQmlListProperty<QQuickItem> *list, QQuickItem *item);
+    Q_NODISCARD static ListSizeType hitTestVisibleItemCount(QQmlListProperty<QQuickItem> *list);
+    Q_NODISCARD static QQuickItem *hitTestVisibleItemAt(QQmlListProperty<QQuickItem> *list, ListSizeType index);
+    static void clearHitTestVisibleItems(QQmlListProperty<QQuickItem> *list);
+
+private:
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(FramelessQuickHelper, qreal, m_resizeBorderThickness, 8.0, &FramelessQuickHelper::resizeBorderThicknessChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(FramelessQuickHelper, qreal, m_titleBarHeight, 31.0, &FramelessQuickHelper::titleBarHeightChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(FramelessQuickHelper, bool, m_resizable, true, &FramelessQuickHelper::resizableChanged)
+#else
+    qreal m_resizeBorderThickness = 8.0;
+    qreal m_titleBarHeight = 31.0;
+    bool m_resizable = true;
+#endif
+    // Set while the cached values are being refreshed from the window, so that
+    // they won't be written back and override the system values.
+    bool m_updatingFromWindow = false;
+    quint8 m_pendingWrites = 0;
+    QList<QMetaObject::Connection> m_windowConnections = {};
+    QQuickItem *m_titleBarItem = nullptr;
+    // In window coordinates, empty if the item is hidden.
+    QRect m_titleBarRect = {};
+    QList<QMetaObject::Connection> m_titleBarConnections = {};
+    QList<QQuickItem *> m_hitTestVisibleItems = {};
+    QHash<QQuickItem *, QMetaObject::Connection> m_hitTestVisibleItemConnections = {};
+    HitTestTable m_hitTestTable;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,493 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessquicktitlebar.h"
+#include "framelesswindowsmanager.h"
+#include "framelessglyphatlas.h"
+#include "framelesstitlebarpalette.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qvariant.h>
+#include <QtGui/qfontmetrics.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qpainter.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgsimplerectnode.h>
+#include <QtQuick/qsgsimpletexturenode.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr qreal kButtonWidthFactor = 1.5;
+static constexpr qreal kCaptionMargin = 10.0;
+
+class FramelessQuickTitleBarNode : public QSGNode
+{
+public:
+    explicit FramelessQuickTitleBarNode() : QSGNode()
+    {
+        m_background = new QSGSimpleRectNode;
+        appendChildNode(m_background);
+        m_highlight = new QSGSimpleRectNode;
+        appendChildNode(m_highlight);
+    }
+
+    ~FramelessQuickTitleBarNode() override
+    {
+        // The glyph nodes don't own the atlas textures, we do. The atlases themselves
+        // are shared by all windows and released together with the last reference.
+        qDeleteAll(m_glyphTextures);
+    }
+
+    QSGSimpleRectNode *m_background = nullptr;
+    QSGSimpleRectNode *m_highlight = nullptr;
+    QSGSimpleTextureNode *m_caption = nullptr;
+    QSGSimpleTextureNode *m_glyphs[3] = {nullptr, nullptr, nullptr};
+    QHash<QRgb, QSGTexture *> m_glyphTextures = {};
+    QHash<QRgb, GlyphAtlas> m_glyphAtlases = {};
+    qreal m_glyphDevicePixelRatio = 0.0;
+};
+
+FramelessQuickTitleBar::FramelessQuickTitleBar(QQuickItem *parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptHoverEvents(true);
+    updateWindowConnections(window());
+}
+
+FramelessQuickTitleBar::~FramelessQuickTitleBar()
+{
+    QQuickWindow *win = window();
+    if (win) {
+        FramelessWindowsManager::setHitTestVisible(win, this, false);
+    }
+}
+
+QString FramelessQuickTitleBar::title() const
+{
+    return m_title;
+}
+
+void FramelessQuickTitleBar::setTitle(const QString &value)
+{
+    m_titleExplicitlySet = true;
+    if (m_title == value) {
+        return;
+    }
+    m_title = value;
+    invalidateCaption();
+    Q_EMIT titleChanged();
+}
+
+void FramelessQuickTitleBar::resetTitle()
+{
+    m_titleExplicitlySet = false;
+    const QQuickWindow *win = window();
+    const QString value = (win ? win->title() : QString{});
+    if (m_title == value) {
+        return;
+    }
+    m_title = value;
+    invalidateCaption();
+    Q_EMIT titleChanged();
+}
+
+QColor FramelessQuickTitleBar::color() const
+{
+    return m_color;
+}
+
+void FramelessQuickTitleBar::setColor(const QColor &value)
+{
+    if (m_color == value) {
+        return;
+    }
+    m_color = value;
+    update();
+    Q_EMIT colorChanged();
+}
+
+QColor FramelessQuickTitleBar::textColor() const
+{
+    return m_textColor;
+}
+
+void FramelessQuickTitleBar::setTextColor(const QColor &value)
+{
+    if (m_textColor == value) {
+        return;
+    }
+    m_textColor = value;
+    invalidateCaption();
+    Q_EMIT textColorChanged();
+}
+
+QSGNode *FramelessQuickTitleBar::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    QQuickWindow *win = window();
+    const QRectF bounds = boundingRect();
+    if (!win || bounds.isEmpty()) {
+        delete oldNode;
+        return nullptr;
+    }
+    auto node = static_cast<FramelessQuickTitleBarNode *>(oldNode);
+    if (!node) {
+        node = new FramelessQuickTitleBarNode;
+    }
+
+    node->m_background->setRect(bounds);
+    node->m_background->setColor(m_color);
+
+    const Button highlighted = ((m_pressedButton != Button::None) ? m_pressedButton : m_hoveredButton);
+    if (highlighted == Button::None) {
+        node->m_highlight->setRect(QRectF());
+    } else {
+        const bool pressed = (m_pressedButton != Button::None);
+        const bool close = (highlighted == Button::Close);
+        node->m_highlight->setRect(buttonRect(highlighted));
+        node->m_highlight->setColor(close ? (pressed ? kCloseButtonPressColor : kCloseButtonHoverColor)
+                                          : (pressed ? kButtonPressColor : kButtonHoverColor));
+    }
+
+    if (m_captionChanged) {
+        if (m_captionImage.isNull()) {
+            delete node->m_caption;
+            node->m_caption = nullptr;
+        } else {
+            if (!node->m_caption) {
+                node->m_caption = new QSGSimpleTextureNode;
+                node->m_caption->setOwnsTexture(true);
+                node->insertChildNodeAfter(node->m_caption, node->m_highlight);
+            }
+            node->m_caption->setTexture(win->createTextureFromImage(m_captionImage));
+            const QSizeF captionSize = (QSizeF(m_captionImage.size()) / m_captionImage.devicePixelRatio());
+            node->m_caption->setRect(QRectF(QPointF(kCaptionMargin, 0.0), captionSize));
+        }
+        // Uploaded, no need to keep a copy around.
+        m_captionImage = {};
+        m_captionChanged = false;
+    }
+
+    const qreal dpr = win->effectiveDevicePixelRatio();
+    if (!qFuzzyCompare(node->m_glyphDevicePixelRatio, dpr)) {
+        for (auto &&glyph : node->m_glyphs) {
+            delete glyph;
+            glyph = nullptr;
+        }
+        qDeleteAll(node->m_glyphTextures);
+        node->m_glyphTextures.clear();
+        node->m_glyphAtlases.clear();
+        node->m_glyphDevicePixelRatio = dpr;
+    }
+    const auto glyphAtlas = [node, win, dpr](const QColor &color) -> GlyphAtlas {
+        const QRgb key = color.rgba();
+        auto it = node->m_glyphAtlases.constFind(key);
+        if (it == node->m_glyphAtlases.constEnd()) {
+            it = node->m_glyphAtlases.insert(key, GlyphAtlas(dpr, color));
+            node->m_glyphTextures.insert(key, win->createTextureFromImage(it.value().image()));
+        }
+        return it.value();
+    };
+    const bool maximized = isWindowMaximized();
+    for (int i = 0; i != 3; ++i) {
+        const auto button = static_cast<Button>(i);
+        QSGSimpleTextureNode *&glyphNode = node->m_glyphs[i];
+        if (!glyphNode) {
+            glyphNode = new QSGSimpleTextureNode;
+            glyphNode->setOwnsTexture(false);
+            glyphNode->setFiltering(QSGTexture::Linear);
+            node->appendChildNode(glyphNode);
+        }
+        const bool whiteGlyph = ((button == Button::Close) && (highlighted == Button::Close));
+        const SystemButtonGlyph glyph = [button, maximized]{
+            switch (button) {
+            case Button::Minimize:
+                return SystemButtonGlyph::Minimize;
+            case Button::Maximize:
+                return (maximized ? SystemButtonGlyph::Restore : SystemButtonGlyph::Maximize);
+            default:
+                break;
+            }
+            return SystemButtonGlyph::Close;
+        }();
+        const QColor glyphColor = (whiteGlyph ? QColor(Qt::white) : m_textColor);
+        const GlyphAtlas atlas = glyphAtlas(glyphColor);
+        glyphNode->setTexture(node->m_glyphTextures.value(glyphColor.rgba()));
+        glyphNode->setSourceRect(atlas.glyphRect(glyph));
+        const QRectF rect = buttonRect(button);
+        const QSizeF glyphSize = atlas.glyphSize();
+        glyphNode->setRect(QRectF(QPointF(rect.center().x() - (glyphSize.width() / 2.0),
+                                          rect.center().y() - (glyphSize.height() / 2.0)), glyphSize));
+    }
+    return node;
+}
+
+void FramelessQuickTitleBar::updatePolish()
+{
+    QQuickItem::updatePolish();
+    if (!m_captionDirty) {
+        return;
+    }
+    m_captionDirty = false;
+    const QQuickWindow *win = window();
+    const qreal captionWidth = (buttonRect(Button::Minimize).left() - (kCaptionMargin * 2.0));
+    if (!win || m_title.isEmpty() || (captionWidth <= 0.0) || (height() <= 0.0)) {
+        m_captionImage = {};
+    } else {
+        // Rasterize the caption on the GUI thread, the render thread only needs to
+        // upload the result.
+        const qreal dpr = win->effectiveDevicePixelRatio();
+        const QFont font = QGuiApplication::font();
+        const QFontMetricsF metrics(font);
+        const QString text = metrics.elidedText(m_title, Qt::ElideRight, captionWidth);
+        const QSizeF size = {qMin(captionWidth, metrics.horizontalAdvance(text) + 1.0), height()};
+        QImage image((size * dpr).toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(font);
+        painter.setPen(m_textColor);
+        painter.drawText(QRectF(QPointF(0.0, 0.0), size), (Qt::AlignLeft | Qt::AlignVCenter), text);
+        painter.end();
+        m_captionImage = image;
+    }
+    m_captionChanged = true;
+    update();
+}
+
+void FramelessQuickTitleBar::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemSceneChange) {
+        QQuickWindow *oldWindow = window();
+        if (oldWindow && (oldWindow != value.window)) {
+            FramelessWindowsManager::setHitTestVisible(oldWindow, this, false);
+        }
+    }
+    QQuickItem::itemChange(change, value);
+    if (change == ItemSceneChange) {
+        updateWindowConnections(value.window);
+    } else if (change == ItemDevicePixelRatioHasChanged) {
+        invalidateCaption();
+    }
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+void FramelessQuickTitleBar::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+#else
+void FramelessQuickTitleBar::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+#endif
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+#else
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+#endif
+    if (newGeometry.size() == oldGeometry.size()) {
+        return;
+    }
+    if (!qFuzzyCompare(newGeometry.height(), oldGeometry.height())) {
+        QQuickWindow *win = window();
+        if (win && (newGeometry.height() > 0.0)) {
+            FramelessWindowsManager::setTitleBarHeight(win, qRound(newGeometry.height()));
+        }
+    }
+    updateHitTestRegions();
+    invalidateCaption();
+}
+
+void FramelessQuickTitleBar::hoverEnterEvent(QHoverEvent *event)
+{
+    QQuickItem::hoverEnterEvent(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    setHoveredButton(buttonAt(event->position()));
+#else
+    setHoveredButton(buttonAt(event->posF()));
+#endif
+}
+
+void FramelessQuickTitleBar::hoverMoveEvent(QHoverEvent *event)
+{
+    QQuickItem::hoverMoveEvent(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    setHoveredButton(buttonAt(event->position()));
+#else
+    setHoveredButton(buttonAt(event->posF()));
+#endif
+}
+
+void FramelessQuickTitleBar::hoverLeaveEvent(QHoverEvent *event)
+{
+    QQuickItem::hoverLeaveEvent(event);
+    setHoveredButton(Button::None);
+}
+
+void FramelessQuickTitleBar::mousePressEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const Button button = buttonAt(event->position());
+#else
+    const Button button = buttonAt(event->localPos());
+#endif
+    if (button == Button::None) {
+        // Leave it to the frameless helper, it's the caption area.
+        event->ignore();
+        return;
+    }
+    m_pressedButton = button;
+    event->accept();
+    update();
+}
+
+void FramelessQuickTitleBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    const Button pressed = m_pressedButton;
+    m_pressedButton = Button::None;
+    update();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const Button button = buttonAt(event->position());
+#else
+    const Button button = buttonAt(event->localPos());
+#endif
+    QQuickWindow *win = window();
+    if (!win || (pressed == Button::None) || (button != pressed)) {
+        return;
+    }
+    event->accept();
+    switch (button) {
+    case Button::Minimize:
+        win->showMinimized();
+        break;
+    case Button::Maximize:
+        if (isWindowMaximized()) {
+            win->showNormal();
+        } else {
+            win->showMaximized();
+        }
+        break;
+    case Button::Close:
+        win->close();
+        break;
+    default:
+        break;
+    }
+}
+
+void FramelessQuickTitleBar::mouseUngrabEvent()
+{
+    QQuickItem::mouseUngrabEvent();
+    if (m_pressedButton != Button::None) {
+        m_pressedButton = Button::None;
+        update();
+    }
+}
+
+QRectF FramelessQuickTitleBar::buttonRect(const Button button) const
+{
+    if (button == Button::None) {
+        return {};
+    }
+    const qreal h = height();
+    const qreal w = qRound(h * kButtonWidthFactor);
+    // From right to left: close, maximize, minimize.
+    const int indexFromRight = (2 - static_cast<int>(button));
+    return {width() - (w * (indexFromRight + 1)), 0.0, w, h};
+}
+
+FramelessQuickTitleBar::Button FramelessQuickTitleBar::buttonAt(const QPointF &pos) const
+{
+    for (int i = 0; i != 3; ++i) {
+        const auto button = static_cast<Button>(i);
+        if (buttonRect(button).contains(pos)) {
+            return button;
+        }
+    }
+    return Button::None;
+}
+
+bool FramelessQuickTitleBar::isWindowMaximized() const
+{
+    const QQuickWindow *win = window();
+    if (!win) {
+        return false;
+    }
+    const QWindow::Visibility visibility = win->visibility();
+    return ((visibility == QWindow::Maximized) || (visibility == QWindow::FullScreen));
+}
+
+void FramelessQuickTitleBar::setHoveredButton(const Button button)
+{
+    if (m_hoveredButton == button) {
+        return;
+    }
+    m_hoveredButton = button;
+    update();
+}
+
+void FramelessQuickTitleBar::updateWindowConnections(QQuickWindow *window)
+{
+    for (auto &&connection : qAsConst(m_windowConnections)) {
+        disconnect(connection);
+    }
+    m_windowConnections.clear();
+    if (!window) {
+        return;
+    }
+    m_windowConnections.append(connect(window, &QWindow::windowTitleChanged, this, [this](){
+        if (!m_titleExplicitlySet) {
+            resetTitle();
+        }
+    }));
+    m_windowConnections.append(connect(window, &QWindow::visibilityChanged, this, [this](){
+        update();
+    }));
+    if (!m_titleExplicitlySet) {
+        resetTitle();
+    }
+    // Our buttons must stay clickable, everything else is the caption area.
+    FramelessWindowsManager::setHitTestVisible(window, this, true);
+    if (height() > 0.0) {
+        FramelessWindowsManager::setTitleBarHeight(window, qRound(height()));
+    }
+    updateHitTestRegions();
+    invalidateCaption();
+}
+
+void FramelessQuickTitleBar::updateHitTestRegions()
+{
+    const QList<QRectF> rects = {
+        buttonRect(Button::Minimize),
+        buttonRect(Button::Maximize),
+        buttonRect(Button::Close)
+    };
+    setProperty(Constants::kHitTestVisibleRectsFlag, QVariant::fromValue(rects));
+}
+
+void FramelessQuickTitleBar::invalidateCaption()
+{
+    m_captionDirty = true;
+    polish();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
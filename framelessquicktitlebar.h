@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtGui/qcolor.h>
+#include <QtGui/qimage.h>
+#include <QtQml/qqml.h>
+#include <QtQuick/qquickitem.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FRAMELESSHELPER_QUICK_API FramelessQuickTitleBar : public QQuickItem
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FramelessQuickTitleBar)
+#ifdef QML_NAMED_ELEMENT
+    QML_NAMED_ELEMENT(FramelessTitleBar)
+#endif
+    Q_PROPERTY(QString title READ title WRITE setTitle RESET resetTitle NOTIFY titleChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor textColor READ textColor WRITE setTextColor NOTIFY textColorChanged)
+
+public:
+    enum class Button : int
+    {
+        None = -1,
+        Minimize = 0,
+        Maximize,
+        Close
+    };
+    Q_ENUM(Button)
+
+    explicit FramelessQuickTitleBar(QQuickItem *parent = nullptr);
+    ~FramelessQuickTitleBar() override;
+
+    Q_NODISCARD QString title() const;
+    void setTitle(const QString &value);
+    void resetTitle();
+
+    Q_NODISCARD QColor color() const;
+    void setColor(const QColor &value);
+
+    Q_NODISCARD QColor textColor() const;
+    void setTextColor(const QColor &value);
+
+Q_SIGNALS:
+    void titleChanged();
+    void colorChanged();
+    void textColorChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void updatePolish() override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#else
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#endif
+    void hoverEnterEvent(QHoverEvent *event) override;
+    void hoverMoveEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseUngrabEvent() override;
+
+private:
+    Q_NODISCARD QRectF buttonRect(const Button button) const;
+    Q_NODISCARD Button buttonAt(const QPointF &pos) const;
+    Q_NODISCARD bool isWindowMaximized() const;
+    void setHoveredButton(const Button button);
+    void updateWindowConnections(QQuickWindow *window);
+    void updateHitTestRegions();
+    void invalidateCaption();
+
+private:
+    QString m_title = {};
+    bool m_titleExplicitlySet = false;
+    QColor m_color = Qt::white;
+    QColor m_textColor = Qt::black;
+    Button m_hoveredButton = Button::None;
+    Button m_pressedButton = Button::None;
+    // Prepared on the GUI thread in updatePolish(), only uploaded in updatePaintNode().
+    QImage m_captionImage = {};
+    bool m_captionDirty = true;
+    bool m_captionChanged = false;
+    QList<QMetaObject::Connection> m_windowConnections = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessquickwindow.h"
+#include <QtGui/qevent.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+FramelessQuickWindow::FramelessQuickWindow(QWindow *parent) : QQuickWindow(parent), FramelessWindowBase(this) {}
+
+FramelessQuickWindow::~FramelessQuickWindow() = default;
+
+bool FramelessQuickWindow::event(QEvent *event)
+{
+    handleWindowEvent(event);
+    return QQuickWindow::event(event);
+}
+
+void FramelessQuickWindow::mousePressEvent(QMouseEvent *event)
+{
+    // Hit-test visible items report themselves as the client area, so the
+    // events only reach the scene when they are meant for it.
+    if (handleMousePressEvent(event)) {
+        event->accept();
+        return;
+    }
+    QQuickWindow::mousePressEvent(event);
+}
+
+void FramelessQuickWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    if (handleMouseMoveEvent(event)) {
+        event->accept();
+        return;
+    }
+    QQuickWindow::mouseMoveEvent(event);
+}
+
+void FramelessQuickWindow::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (handleMouseReleaseEvent(event)) {
+        event->accept();
+        return;
+    }
+    QQuickWindow::mouseReleaseEvent(event);
+}
+
+void FramelessQuickWindow::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (handleMouseDoubleClickEvent(event)) {
+        event->accept();
+        return;
+    }
+    QQuickWindow::mouseDoubleClickEvent(event);
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool FramelessQuickWindow::nativeEvent(const QByteArray &eventType, void *message, qintptr *result)
+#else
+bool FramelessQuickWindow::nativeEvent(const QByteArray &eventType, void *message, long *result)
+#endif
+{
+    if (handleNativeEvent(eventType, message, result)) {
+        return true;
+    }
+    return QQuickWindow::nativeEvent(eventType, message, result);
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,215 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessscreenwatcher.h"
+#include <QtGui/qscreen.h>
+#include "utilities.h"
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+ScreenDpiWatcher::ScreenDpiWatcher(const Applier applier, QObject *parent) : QObject(parent), m_applier(applier)
+{
+}
+
+ScreenDpiWatcher::~ScreenDpiWatcher()
+{
+    for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
+        disconnect(it.value().screenChangedConnection);
+        disconnect(it.value().destroyedConnection);
+    }
+    for (auto it = m_screens.constBegin(); it != m_screens.constEnd(); ++it) {
+        for (auto &&connection : qAsConst(it.value())) {
+            disconnect(connection);
+        }
+    }
+}
+
+void ScreenDpiWatcher::addWindow(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window || m_windows.contains(window)) {
+        return;
+    }
+    WindowData data = {};
+    data.window = window;
+    data.screen = window->screen();
+    data.metrics = calculateMetrics(window);
+    data.screenChangedConnection = connect(window, &QWindow::screenChanged, this, [this, window](QScreen *screen){
+        handleScreenChanged(window, screen);
+    });
+    // The QWindow part is already gone at this point, only the address is used.
+    data.destroyedConnection = connect(window, &QObject::destroyed, this, [this, window](){
+        const QPointer<QScreen> screen = m_windows.value(window).screen;
+        m_windows.remove(window);
+        unsubscribeIfUnused(screen);
+    });
+    m_windows.insert(window, data);
+    subscribe(data.screen);
+}
+
+void ScreenDpiWatcher::removeWindow(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const auto it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return;
+    }
+    disconnect(it.value().screenChangedConnection);
+    disconnect(it.value().destroyedConnection);
+    const QPointer<QScreen> screen = it.value().screen;
+    m_windows.erase(it);
+    unsubscribeIfUnused(screen);
+}
+
+ScreenMetrics ScreenDpiWatcher::metrics(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    return m_windows.value(const_cast<QWindow *>(window)).metrics;
+}
+
+ScreenMetrics ScreenDpiWatcher::calculateMetrics(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    ScreenMetrics metrics = {};
+    metrics.devicePixelRatio = window->devicePixelRatio();
+    if (const QScreen *screen = window->screen()) {
+        metrics.logicalDotsPerInch = screen->logicalDotsPerInch();
+    }
+    metrics.resizeBorderThickness = Utilities::getSystemMetric(window, SystemMetric::ResizeBorderThickness, true);
+    metrics.titleBarHeight = Utilities::getSystemMetric(window, SystemMetric::TitleBarHeight, true);
+    return metrics;
+}
+
+void ScreenDpiWatcher::subscribe(QScreen *screen)
+{
+    if (!screen || m_screens.contains(screen)) {
+        return;
+    }
+    QList<QMetaObject::Connection> connections = {};
+    connections.append(connect(screen, &QScreen::logicalDotsPerInchChanged, this, [this, screen](){
+        refreshScreen(screen);
+    }));
+    connections.append(connect(screen, &QScreen::physicalDotsPerInchChanged, this, [this, screen](){
+        refreshScreen(screen);
+    }));
+    connections.append(connect(screen, &QObject::destroyed, this, [this, screen](){
+        m_screens.remove(screen);
+    }));
+    m_screens.insert(screen, connections);
+}
+
+void ScreenDpiWatcher::unsubscribeIfUnused(QScreen *screen)
+{
+    if (!screen) {
+        return;
+    }
+    for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
+        if (it.value().screen.data() == screen) {
+            return;
+        }
+    }
+    const QList<QMetaObject::Connection> connections = m_screens.take(screen);
+    for (auto &&connection : qAsConst(connections)) {
+        disconnect(connection);
+    }
+}
+
+void ScreenDpiWatcher::handleScreenChanged(QWindow *window, QScreen *screen)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const auto it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return;
+    }
+    const QPointer<QScreen> oldScreen = it.value().screen;
+    it.value().screen = screen;
+    subscribe(screen);
+    unsubscribeIfUnused(oldScreen);
+    refreshWindow(window);
+}
+
+void ScreenDpiWatcher::refreshScreen(QScreen *screen)
+{
+    Q_ASSERT(screen);
+    if (!screen) {
+        return;
+    }
+    // Collect them first, the appliers are free to add or remove windows.
+    QList<QWindow *> windows = {};
+    for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
+        if ((it.value().screen.data() == screen) && it.value().window) {
+            windows.append(it.key());
+        }
+    }
+    for (auto &&window : qAsConst(windows)) {
+        refreshWindow(window);
+    }
+}
+
+void ScreenDpiWatcher::refreshWindow(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const auto it = m_windows.find(window);
+    if ((it == m_windows.end()) || !it.value().window) {
+        return;
+    }
+    const ScreenMetrics metrics = calculateMetrics(window);
+    const ScreenMetrics &oldMetrics = it.value().metrics;
+    Changes changes = {};
+    if (!qFuzzyCompare(metrics.devicePixelRatio, oldMetrics.devicePixelRatio)) {
+        changes |= Change::DevicePixelRatio;
+    }
+    if (!qFuzzyCompare(metrics.logicalDotsPerInch, oldMetrics.logicalDotsPerInch)) {
+        changes |= Change::LogicalDotsPerInch;
+    }
+    if ((metrics.resizeBorderThickness != oldMetrics.resizeBorderThickness)
+            || (metrics.titleBarHeight != oldMetrics.titleBarHeight)) {
+        changes |= Change::FrameMetrics;
+    }
+    if (!changes) {
+        return;
+    }
+    it.value().metrics = metrics;
+    if (m_applier) {
+        m_applier(window, changes);
+    }
+    Q_EMIT metricsChanged(window, changes);
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
+#include <QtGui/qwindow.h>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QScreen)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The DPI dependent values the frame of a window is computed from.
+struct ScreenMetrics
+{
+    qreal devicePixelRatio = 1.0;
+    qreal logicalDotsPerInch = 96.0;
+    int resizeBorderThickness = 0;
+    int titleBarHeight = 0;
+};
+
+// Keeps the DPI dependent metrics of the managed windows up to date. Each screen
+// is only subscribed to once, no matter how many windows are placed on it, and
+// a DPI change of a screen refreshes all its windows in one pass. Only the
+// windows whose metrics really changed are updated.
+class FRAMELESSHELPER_API ScreenDpiWatcher : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ScreenDpiWatcher)
+
+public:
+    enum class Change : int
+    {
+        DevicePixelRatio = 0x01,
+        LogicalDotsPerInch = 0x02,
+        FrameMetrics = 0x04
+    };
+    Q_ENUM(Change)
+    Q_DECLARE_FLAGS(Changes, Change)
+    Q_FLAG(Changes)
+
+    // Applies the frame updates, called before metricsChanged() is emitted.
+    using Applier = void(*)(QWindow *window, const Changes changes);
+
+    explicit ScreenDpiWatcher(const Applier applier = nullptr, QObject *parent = nullptr);
+    ~ScreenDpiWatcher() override;
+
+    void addWindow(QWindow *window);
+    void removeWindow(QWindow *window);
+    [[nodiscard]] ScreenMetrics metrics(const QWindow *window) const;
+
+Q_SIGNALS:
+    void metricsChanged(QWindow *window, const ScreenDpiWatcher::Changes changes);
+
+private:
+    [[nodiscard]] static ScreenMetrics calculateMetrics(const QWindow *window);
+    void subscribe(QScreen *screen);
+    void unsubscribeIfUnused(QScreen *screen);
+    void handleScreenChanged(QWindow *window, QScreen *screen);
+    void refreshScreen(QScreen *screen);
+    void refreshWindow(QWindow *window);
+
+private:
+    struct WindowData
+    {
+        QPointer<QWindow> window = nullptr;
+        QPointer<QScreen> screen = nullptr;
+        ScreenMetrics metrics = {};
+        QMetaObject::Connection screenChangedConnection = {};
+        QMetaObject::Connection destroyedConnection = {};
+    };
+    Applier m_applier = nullptr;
+    QHash<QWindow *, WindowData> m_windows = {};
+    QHash<QScreen *, QList<QMetaObject::Connection>> m_screens = {};
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ScreenDpiWatcher::Changes)
+
+FRAMELESSHELPER_END_NAMESPACE
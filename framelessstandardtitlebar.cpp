@@ -0,0 +1,362 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessstandardtitlebar.h"
+#include "framelessthemenotifier.h"
+#include "framelesstitlebarpalette.h"
+#include "framelesswindowsmanager.h"
+#include "utilities.h"
+#include <QtCore/qvariant.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr int kCaptionMargin = 10;
+static constexpr qreal kButtonWidthFactor = 1.5;
+
+StandardTitleBar::StandardTitleBar(QWidget *parent) : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMouseTracking(true);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(m_titleBarHeight);
+    updateTheme();
+    attachToWindow();
+    connect(ThemeChangeNotifier::instance(), &ThemeChangeNotifier::themeChanged, this, &StandardTitleBar::updateTheme);
+}
+
+StandardTitleBar::~StandardTitleBar()
+{
+    if (m_windowHandle) {
+        FramelessWindowsManager::setHitTestVisible(m_windowHandle, this, false);
+    }
+}
+
+QSize StandardTitleBar::sizeHint() const
+{
+    return {qRound(static_cast<qreal>(m_titleBarHeight) * kButtonWidthFactor) * 3, m_titleBarHeight};
+}
+
+void StandardTitleBar::updateTheme()
+{
+    const ColorizationArea area = Utilities::getColorizationArea();
+    m_dark = Utilities::shouldAppsUseDarkMode();
+    m_colorizedTitleBar = ((area == ColorizationArea::TitleBar_WindowBorder) || (area == ColorizationArea::All));
+    m_colorizationColor = Utilities::getColorizationColor();
+    update();
+}
+
+bool StandardTitleBar::eventFilter(QObject *object, QEvent *event)
+{
+    if (object == m_window.data()) {
+        switch (event->type()) {
+        case QEvent::Show:
+        case QEvent::WinIdChange:
+            attachToWindow();
+            break;
+        case QEvent::WindowStateChange:
+            // Only the maximize button has to be repainted.
+            update(buttonRect(Button::Maximize));
+            break;
+        case QEvent::WindowTitleChange:
+            updateCaption();
+            break;
+        default:
+            break;
+        }
+    }
+    return QWidget::eventFilter(object, event);
+}
+
+void StandardTitleBar::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    switch (event->type()) {
+    case QEvent::ParentChange:
+        attachToWindow();
+        break;
+    case QEvent::FontChange:
+        updateCaption();
+        break;
+    case QEvent::ActivationChange:
+        update();
+        break;
+    default:
+        break;
+    }
+}
+
+void StandardTitleBar::paintEvent(QPaintEvent *event)
+{
+    const bool active = (m_window ? m_window->isActiveWindow() : true);
+    const QColor backgroundColor = [this, active]() -> QColor {
+        if (active) {
+            if (m_colorizedTitleBar) {
+                return m_colorizationColor;
+            }
+            return (m_dark ? Qt::black : Qt::white);
+        }
+        return (m_dark ? kSystemDarkColor : QColor(Qt::white));
+    }();
+    QPainter painter(this);
+    painter.fillRect(event->rect(), backgroundColor);
+    if (!m_elidedTitle.isEmpty()) {
+        const QRect captionRect = {kCaptionMargin, 0, (buttonRect(Button::Minimize).left() - (kCaptionMargin * 2)), height()};
+        if (captionRect.intersects(event->rect())) {
+            painter.setPen(active ? (m_dark ? Qt::white : Qt::black) : Qt::darkGray);
+            painter.drawText(captionRect, (Qt::AlignLeft | Qt::AlignVCenter), m_elidedTitle);
+        }
+    }
+    for (int i = 0; i != 3; ++i) {
+        const auto button = static_cast<Button>(i);
+        const QRect rect = buttonRect(button);
+        if (rect.intersects(event->rect())) {
+            paintButton(&painter, button);
+        }
+    }
+}
+
+void StandardTitleBar::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateHitTestRegions();
+    updateCaption();
+}
+
+void StandardTitleBar::mouseMoveEvent(QMouseEvent *event)
+{
+    QWidget::mouseMoveEvent(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const Button button = buttonAt(event->position().toPoint());
+#else
+    const Button button = buttonAt(event->pos());
+#endif
+    if (button == m_hoveredButton) {
+        return;
+    }
+    update(buttonRect(m_hoveredButton));
+    update(buttonRect(button));
+    m_hoveredButton = button;
+}
+
+void StandardTitleBar::mousePressEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const Button button = buttonAt(event->position().toPoint());
+#else
+    const Button button = buttonAt(event->pos());
+#endif
+    if ((button == Button::None) || (event->button() != Qt::LeftButton)) {
+        // It's the caption area, leave it to the frameless helper.
+        event->ignore();
+        return;
+    }
+    m_pressedButton = button;
+    update(buttonRect(button));
+}
+
+void StandardTitleBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    const Button pressed = m_pressedButton;
+    if (pressed == Button::None) {
+        event->ignore();
+        return;
+    }
+    m_pressedButton = Button::None;
+    update(buttonRect(pressed));
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const Button button = buttonAt(event->position().toPoint());
+#else
+    const Button button = buttonAt(event->pos());
+#endif
+    if ((button != pressed) || !m_window) {
+        return;
+    }
+    switch (button) {
+    case Button::Minimize:
+        m_window->showMinimized();
+        break;
+    case Button::Maximize:
+        if (isWindowMaximized()) {
+            m_window->showNormal();
+        } else {
+            m_window->showMaximized();
+        }
+        break;
+    case Button::Close:
+        m_window->close();
+        break;
+    default:
+        break;
+    }
+}
+
+void StandardTitleBar::leaveEvent(QEvent *event)
+{
+    QWidget::leaveEvent(event);
+    if (m_hoveredButton != Button::None) {
+        update(buttonRect(m_hoveredButton));
+        m_hoveredButton = Button::None;
+    }
+}
+
+QRect StandardTitleBar::buttonRect(const Button button) const
+{
+    if (button == Button::None) {
+        return {};
+    }
+    const int h = height();
+    const int w = qRound(static_cast<qreal>(h) * kButtonWidthFactor);
+    // From right to left: close, maximize, minimize.
+    const int indexFromRight = (2 - static_cast<int>(button));
+    return {width() - (w * (indexFromRight + 1)), 0, w, h};
+}
+
+StandardTitleBar::Button StandardTitleBar::buttonAt(const QPoint &pos) const
+{
+    for (int i = 0; i != 3; ++i) {
+        const auto button = static_cast<Button>(i);
+        if (buttonRect(button).contains(pos)) {
+            return button;
+        }
+    }
+    return Button::None;
+}
+
+void StandardTitleBar::paintButton(QPainter *painter, const Button button) const
+{
+    Q_ASSERT(painter);
+    if (!painter) {
+        return;
+    }
+    const bool close = (button == Button::Close);
+    const bool pressed = (m_pressedButton == button);
+    const bool hovered = ((m_pressedButton == Button::None) && (m_hoveredButton == button));
+    const QRect rect = buttonRect(button);
+    if (pressed || hovered) {
+        painter->fillRect(rect, close ? (pressed ? kCloseButtonPressColor : kCloseButtonHoverColor)
+                                      : (pressed ? kButtonPressColor : kButtonHoverColor));
+    }
+    const SystemButtonGlyph glyph = [this, button]{
+        switch (button) {
+        case Button::Minimize:
+            return SystemButtonGlyph::Minimize;
+        case Button::Maximize:
+            return (isWindowMaximized() ? SystemButtonGlyph::Restore : SystemButtonGlyph::Maximize);
+        default:
+            break;
+        }
+        return SystemButtonGlyph::Close;
+    }();
+    const qreal dpr = devicePixelRatioF();
+    if (!qFuzzyCompare(m_glyphAtlasDevicePixelRatio, dpr)) {
+        // Moved to a screen with a different scale factor, let the other atlases go.
+        m_glyphAtlases.clear();
+        m_glyphAtlasDevicePixelRatio = dpr;
+    }
+    const QColor color = ((m_dark || (close && (pressed || hovered))) ? Qt::white : Qt::black);
+    auto it = m_glyphAtlases.constFind(color.rgba());
+    if (it == m_glyphAtlases.constEnd()) {
+        const GlyphAtlas newAtlas(dpr, color);
+        it = m_glyphAtlases.insert(color.rgba(), {newAtlas, QPixmap::fromImage(newAtlas.image())});
+    }
+    const GlyphAtlas &atlas = it.value().atlas;
+    const QSizeF glyphSize = atlas.glyphSize();
+    // Snap to the device pixel grid, the atlas is already rasterized at this scale.
+    const QPointF topLeft = {qRound((rect.center().x() + 0.5 - (glyphSize.width() / 2.0)) * dpr) / dpr,
+                             qRound((rect.center().y() + 0.5 - (glyphSize.height() / 2.0)) * dpr) / dpr};
+    painter->drawPixmap(QRectF(topLeft, glyphSize), it.value().pixmap, atlas.glyphRect(glyph));
+}
+
+bool StandardTitleBar::isWindowMaximized() const
+{
+    if (!m_window) {
+        return false;
+    }
+    return (m_window->isMaximized() || m_window->isFullScreen());
+}
+
+void StandardTitleBar::attachToWindow()
+{
+    QWidget *win = window();
+    if (m_window != win) {
+        if (m_window) {
+            m_window->removeEventFilter(this);
+        }
+        m_window = win;
+        if (m_window && (m_window != this)) {
+            m_window->installEventFilter(this);
+        }
+    }
+    QWindow *handle = (m_window ? m_window->windowHandle() : nullptr);
+    if (m_windowHandle != handle) {
+        if (m_windowHandle) {
+            FramelessWindowsManager::setHitTestVisible(m_windowHandle, this, false);
+        }
+        m_windowHandle = handle;
+        if (m_windowHandle) {
+            // Only our buttons are hit-test visible, see updateHitTestRegions().
+            FramelessWindowsManager::setHitTestVisible(m_windowHandle, this, true);
+        }
+    }
+    updateTitleBarHeight();
+    updateHitTestRegions();
+    updateCaption();
+}
+
+void StandardTitleBar::updateTitleBarHeight()
+{
+    if (!m_windowHandle) {
+        return;
+    }
+    const int titleBarHeight = Utilities::getSystemMetric(m_windowHandle, SystemMetric::TitleBarHeight, false);
+    if ((titleBarHeight <= 0) || (titleBarHeight == m_titleBarHeight)) {
+        return;
+    }
+    m_titleBarHeight = titleBarHeight;
+    setFixedHeight(m_titleBarHeight);
+    updateGeometry();
+}
+
+void StandardTitleBar::updateHitTestRegions()
+{
+    const QList<QRectF> rects = {
+        buttonRect(Button::Minimize),
+        buttonRect(Button::Maximize),
+        buttonRect(Button::Close)
+    };
+    setProperty(Constants::kHitTestVisibleRectsFlag, QVariant::fromValue(rects));
+}
+
+void StandardTitleBar::updateCaption()
+{
+    const QString title = (m_window ? m_window->windowTitle() : QString{});
+    const int captionWidth = (buttonRect(Button::Minimize).left() - (kCaptionMargin * 2));
+    m_elidedTitle = ((captionWidth > 0) ? fontMetrics().elidedText(title, Qt::ElideRight, captionWidth) : QString{});
+    update();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include "framelessglyphatlas.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
+#include <QtGui/qcolor.h>
+#include <QtGui/qpixmap.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qwidget.h>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QPainter)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FRAMELESSHELPER_WIDGETS_API StandardTitleBar : public QWidget
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(StandardTitleBar)
+
+public:
+    enum class Button : int
+    {
+        None = -1,
+        Minimize = 0,
+        Maximize,
+        Close
+    };
+    Q_ENUM(Button)
+
+    explicit StandardTitleBar(QWidget *parent = nullptr);
+    ~StandardTitleBar() override;
+
+    Q_NODISCARD QSize sizeHint() const override;
+
+public Q_SLOTS:
+    void updateTheme();
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    Q_NODISCARD QRect buttonRect(const Button button) const;
+    Q_NODISCARD Button buttonAt(const QPoint &pos) const;
+    void paintButton(QPainter *painter, const Button button) const;
+    Q_NODISCARD bool isWindowMaximized() const;
+    void attachToWindow();
+    void updateTitleBarHeight();
+    void updateHitTestRegions();
+    void updateCaption();
+
+private:
+    QPointer<QWidget> m_window = nullptr;
+    QPointer<QWindow> m_windowHandle = nullptr;
+    int m_titleBarHeight = 31;
+    bool m_dark = false;
+    bool m_colorizedTitleBar = false;
+    QColor m_colorizationColor = {};
+    Button m_hoveredButton = Button::None;
+    Button m_pressedButton = Button::None;
+    // Only recomputed when the title, the font or the size changes.
+    QString m_elidedTitle = {};
+    struct GlyphPixmap
+    {
+        // Shared with all the other title bars, per DPR and color.
+        GlyphAtlas atlas = {};
+        QPixmap pixmap = {};
+    };
+    mutable QHash<QRgb, GlyphPixmap> m_glyphAtlases = {};
+    mutable qreal m_glyphAtlasDevicePixelRatio = 0.0;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
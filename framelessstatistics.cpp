@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessstatistics.h"
+#include <QtCore/qdebug.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qmutex.h>
+#include <atomic>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+// Everything is recorded with relaxed atomics, without any lock.
+struct CounterStorage
+{
+    std::atomic<quint64> values[StatisticsCounters::kCounterCount] = {};
+
+    void reset()
+    {
+        for (auto &&value : values) {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] StatisticsCounters load() const
+    {
+        StatisticsCounters counters = {};
+        for (int i = 0; i != StatisticsCounters::kCounterCount; ++i) {
+            counters.values[i] = values[i].load(std::memory_order_relaxed);
+        }
+        return counters;
+    }
+};
+
+struct HistogramStorage
+{
+    std::atomic<quint64> buckets[LatencyHistogram::kBucketCount] = {};
+    std::atomic<quint64> count{0};
+    std::atomic<qint64> totalDuration{0};
+
+    void reset()
+    {
+        for (auto &&bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        totalDuration.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] LatencyHistogram load() const
+    {
+        LatencyHistogram histogram = {};
+        for (int i = 0; i != LatencyHistogram::kBucketCount; ++i) {
+            histogram.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        histogram.count = count.load(std::memory_order_relaxed);
+        histogram.totalDuration = totalDuration.load(std::memory_order_relaxed);
+        return histogram;
+    }
+};
+
+static constexpr const quintptr kEmptySlot = 0;
+static constexpr const quintptr kRemovedSlot = 1;
+static constexpr const int kWindowSlotCount = 256;
+
+// The counters of the windows live in a fixed table which is never freed, so
+// that they can be found and incremented without taking a lock. Only adding and
+// removing windows and taking snapshots lock, which all happen rarely.
+struct WindowCounterSlot
+{
+    // kEmptySlot, kRemovedSlot or the address of the window.
+    std::atomic<quintptr> key{kEmptySlot};
+    CounterStorage counters = {};
+    // Only touched while holding the lock.
+    QPointer<QWindow> window = nullptr;
+    QMetaObject::Connection destroyedConnection = {};
+};
+
+struct StatisticsData
+{
+    CounterStorage global = {};
+    HistogramStorage eventFilter = {};
+    HistogramStorage nativeEventFilter = {};
+    QMutex mutex;
+    WindowCounterSlot windows[kWindowSlotCount];
+
+    [[nodiscard]] static int firstSlot(const quintptr key)
+    {
+        // The low bits of an address are always the same.
+        return static_cast<int>((key >> 4) % kWindowSlotCount);
+    }
+
+    // Lock-free. A slot which is reused while a counter is being incremented only
+    // costs a miscount.
+    [[nodiscard]] CounterStorage *findWindow(const QWindow *window)
+    {
+        const auto key = reinterpret_cast<quintptr>(window);
+        int index = firstSlot(key);
+        for (int i = 0; i != kWindowSlotCount; ++i) {
+            const quintptr slotKey = windows[index].key.load(std::memory_order_acquire);
+            if (slotKey == key) {
+                return &windows[index].counters;
+            }
+            if (slotKey == kEmptySlot) {
+                break;
+            }
+            index = ((index + 1) % kWindowSlotCount);
+        }
+        return nullptr;
+    }
+
+    // Must hold the lock.
+    void addWindow(QWindow *window)
+    {
+        const auto key = reinterpret_cast<quintptr>(window);
+        int index = firstSlot(key);
+        WindowCounterSlot *freeSlot = nullptr;
+        for (int i = 0; i != kWindowSlotCount; ++i) {
+            WindowCounterSlot &slot = windows[index];
+            const quintptr slotKey = slot.key.load(std::memory_order_relaxed);
+            if (slotKey == key) {
+                // A new window may have been created at the address of a destroyed one.
+                if (slot.window != window) {
+                    slot.counters.reset();
+                    slot.window = window;
+                }
+                return;
+            }
+            // The window of a slot may have been destroyed without being removed.
+            if (((slotKey == kRemovedSlot) || slot.window.isNull()) && !freeSlot) {
+                freeSlot = &slot;
+            }
+            if (slotKey == kEmptySlot) {
+                if (!freeSlot) {
+                    freeSlot = &slot;
+                }
+                break;
+            }
+            index = ((index + 1) % kWindowSlotCount);
+        }
+        if (!freeSlot) {
+            static bool warned = false;
+            if (!warned) {
+                warned = true;
+                qWarning() << "Too many windows, the statistics of the new ones are only counted globally.";
+            }
+            return;
+        }
+        QObject::disconnect(freeSlot->destroyedConnection);
+        freeSlot->counters.reset();
+        freeSlot->window = window;
+        // The QWindow part is already gone at this point, only the address is used.
+        freeSlot->destroyedConnection = QObject::connect(window, &QObject::destroyed, [window](){
+            Statistics::removeWindow(window);
+        });
+        freeSlot->key.store(key, std::memory_order_release);
+    }
+
+    // Must hold the lock.
+    static void removeSlot(WindowCounterSlot &slot)
+    {
+        slot.key.store(kRemovedSlot, std::memory_order_release);
+        slot.window = nullptr;
+        QObject::disconnect(slot.destroyedConnection);
+        slot.destroyedConnection = {};
+    }
+};
+
+Q_GLOBAL_STATIC(StatisticsData, g_statisticsData)
+#endif
+
+quint64 StatisticsCounters::value(const StatisticsCounter counter) const
+{
+    const auto index = static_cast<int>(counter);
+    Q_ASSERT((index >= 0) && (index < kCounterCount));
+    if ((index < 0) || (index >= kCounterCount)) {
+        return 0;
+    }
+    return values[index];
+}
+
+qint64 LatencyHistogram::percentile(const qreal value) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    const auto rank = qMax(quint64(1), static_cast<quint64>(qCeil(qBound(0.0, value, 1.0) * static_cast<qreal>(count))));
+    quint64 seen = 0;
+    for (int i = 0; i != kBucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return (qint64(1) << (i + 1));
+        }
+    }
+    return (qint64(1) << kBucketCount);
+}
+
+int LatencyHistogram::bucketIndex(const qint64 nsecs)
+{
+    if (nsecs <= 1) {
+        return 0;
+    }
+    const int index = (63 - static_cast<int>(qCountLeadingZeroBits(static_cast<quint64>(nsecs))));
+    return qMin(index, (kBucketCount - 1));
+}
+
+void Statistics::increment(const QWindow *window, const StatisticsCounter counter, const quint64 value)
+{
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    const auto index = static_cast<int>(counter);
+    Q_ASSERT((index >= 0) && (index < StatisticsCounters::kCounterCount));
+    if ((index < 0) || (index >= StatisticsCounters::kCounterCount)) {
+        return;
+    }
+    g_statisticsData()->global.values[index].fetch_add(value, std::memory_order_relaxed);
+    if (window) {
+        // Windows which haven't been added are only counted globally.
+        if (CounterStorage * const counters = g_statisticsData()->findWindow(window)) {
+            counters->values[index].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+#else
+    Q_UNUSED(window);
+    Q_UNUSED(counter);
+    Q_UNUSED(value);
+#endif
+}
+
+void Statistics::recordLatency(const LatencyHistogramType type, const qint64 nsecs)
+{
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    HistogramStorage &histogram = ((type == LatencyHistogramType::NativeEventFilter)
+            ? g_statisticsData()->nativeEventFilter : g_statisticsData()->eventFilter);
+    histogram.buckets[LatencyHistogram::bucketIndex(nsecs)].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.totalDuration.fetch_add(nsecs, std::memory_order_relaxed);
+#else
+    Q_UNUSED(type);
+    Q_UNUSED(nsecs);
+#endif
+}
+
+void Statistics::addWindow(QWindow *window)
+{
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    QMutexLocker locker(&g_statisticsData()->mutex);
+    g_statisticsData()->addWindow(window);
+#else
+    Q_UNUSED(window);
+#endif
+}
+
+void Statistics::removeWindow(const QWindow *window)
+{
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    // Windows may be destroyed after us.
+    if (g_statisticsData.isDestroyed()) {
+        return;
+    }
+    const auto key = reinterpret_cast<quintptr>(window);
+    QMutexLocker locker(&g_statisticsData()->mutex);
+    for (auto &&slot : g_statisticsData()->windows) {
+        if (slot.key.load(std::memory_order_relaxed) == key) {
+            StatisticsData::removeSlot(slot);
+            break;
+        }
+    }
+#else
+    Q_UNUSED(window);
+#endif
+}
+
+FramelessStatistics Statistics::snapshot()
+{
+    FramelessStatistics statistics = {};
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    statistics.enabled = true;
+    statistics.global = g_statisticsData()->global.load();
+    statistics.eventFilter = g_statisticsData()->eventFilter.load();
+    statistics.nativeEventFilter = g_statisticsData()->nativeEventFilter.load();
+    QMutexLocker locker(&g_statisticsData()->mutex);
+    for (auto &&slot : g_statisticsData()->windows) {
+        const quintptr key = slot.key.load(std::memory_order_relaxed);
+        if ((key == kEmptySlot) || (key == kRemovedSlot)) {
+            continue;
+        }
+        if (!slot.window) {
+            StatisticsData::removeSlot(slot);
+            continue;
+        }
+        statistics.windows.append({slot.window, slot.counters.load()});
+    }
+#endif
+    return statistics;
+}
+
+void Statistics::reset()
+{
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+    g_statisticsData()->global.reset();
+    g_statisticsData()->eventFilter.reset();
+    g_statisticsData()->nativeEventFilter.reset();
+    // The windows stay registered, only their counters start over.
+    QMutexLocker locker(&g_statisticsData()->mutex);
+    for (auto &&slot : g_statisticsData()->windows) {
+        slot.counters.reset();
+    }
+#endif
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qlist.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+enum class StatisticsCounter : int
+{
+    EventsFiltered = 0,
+    HitTests,
+    HitTestVisibleObjectsScanned,
+    CursorChanges,
+    FrameChanges,
+    SystemMoves,
+    SystemResizes,
+    MetricCacheHits
+};
+
+enum class LatencyHistogramType : int
+{
+    EventFilter = 0,
+    NativeEventFilter
+};
+
+struct FRAMELESSHELPER_API StatisticsCounters
+{
+    static constexpr const int kCounterCount = (static_cast<int>(StatisticsCounter::MetricCacheHits) + 1);
+
+    quint64 values[kCounterCount] = {};
+
+    [[nodiscard]] quint64 value(const StatisticsCounter counter) const;
+};
+
+struct FRAMELESSHELPER_API LatencyHistogram
+{
+    // Bucket N counts the samples in [2^N, 2^(N+1)) nanoseconds, the first
+    // bucket also counts the zero samples and the last one everything above.
+    static constexpr const int kBucketCount = 40;
+
+    quint64 buckets[kBucketCount] = {};
+    quint64 count = 0;
+    qint64 totalDuration = 0;
+
+    // The upper bound of the bucket the given percentile (0.0 ~ 1.0) falls
+    // into, in nanoseconds.
+    [[nodiscard]] qint64 percentile(const qreal value) const;
+    [[nodiscard]] static int bucketIndex(const qint64 nsecs);
+};
+
+struct WindowStatistics
+{
+    QPointer<QWindow> window = nullptr;
+    StatisticsCounters counters = {};
+};
+
+struct FramelessStatistics
+{
+    // False if the library has been built without FRAMELESSHELPER_ENABLE_STATISTICS,
+    // nothing is recorded in this case.
+    bool enabled = false;
+    // Including the values which can't be attributed to a window.
+    StatisticsCounters global = {};
+    QList<WindowStatistics> windows = {};
+    LatencyHistogram eventFilter = {};
+    LatencyHistogram nativeEventFilter = {};
+};
+
+namespace Statistics
+{
+
+// Use the FRAMELESSHELPER_STATISTICS_* macros below instead, they disappear
+// completely if the statistics are disabled.
+FRAMELESSHELPER_API void increment(const QWindow *window, const StatisticsCounter counter, const quint64 value = 1);
+FRAMELESSHELPER_API void recordLatency(const LatencyHistogramType type, const qint64 nsecs);
+// Only the windows which have been added are counted individually.
+FRAMELESSHELPER_API void addWindow(QWindow *window);
+FRAMELESSHELPER_API void removeWindow(const QWindow *window);
+[[nodiscard]] FRAMELESSHELPER_API FramelessStatistics snapshot();
+FRAMELESSHELPER_API void reset();
+
+class LatencyScope
+{
+    Q_DISABLE_COPY_MOVE(LatencyScope)
+
+public:
+    explicit LatencyScope(const LatencyHistogramType type) : m_type(type)
+    {
+        m_timer.start();
+    }
+
+    ~LatencyScope()
+    {
+        recordLatency(m_type, m_timer.nsecsElapsed());
+    }
+
+private:
+    LatencyHistogramType m_type = LatencyHistogramType::EventFilter;
+    QElapsedTimer m_timer = {};
+};
+
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#ifdef FRAMELESSHELPER_ENABLE_STATISTICS
+#define FRAMELESSHELPER_STATISTICS_ADD(window, counter, value) \
+    FRAMELESSHELPER_PREPEND_NAMESPACE(Statistics)::increment((window), \
+        FRAMELESSHELPER_PREPEND_NAMESPACE(StatisticsCounter)::counter, (value))
+#define FRAMELESSHELPER_STATISTICS_LATENCY(type) \
+    const FRAMELESSHELPER_PREPEND_NAMESPACE(Statistics)::LatencyScope framelessHelperLatencyScope( \
+        FRAMELESSHELPER_PREPEND_NAMESPACE(LatencyHistogramType)::type)
+#else
+#define FRAMELESSHELPER_STATISTICS_ADD(window, counter, value) static_cast<void>(0)
+#define FRAMELESSHELPER_STATISTICS_LATENCY(type) static_cast<void>(0)
+#endif
+
+#define FRAMELESSHELPER_STATISTICS_INCREMENT(window, counter) FRAMELESSHELPER_STATISTICS_ADD(window, counter, 1)
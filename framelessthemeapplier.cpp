@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessthemeapplier.h"
+#include "framelessthemenotifier.h"
+#include "framelesstitlebarpalette.h"
+#include "utilities.h"
+#include <QtGui/qevent.h>
+#include <QtGui/qpalette.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[nodiscard]] static inline QPalette::ColorRole getPaletteRole(const ThemeApplier::Role role)
+{
+    switch (role) {
+    case ThemeApplier::Role::WindowBackground:
+    case ThemeApplier::Role::TitleBarBackground:
+        return QPalette::Window;
+    case ThemeApplier::Role::TitleBarText:
+    case ThemeApplier::Role::Text:
+        break;
+    }
+    return QPalette::WindowText;
+}
+
+ThemeApplier::ThemeApplier(QWidget *window) : QObject(window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    m_window = window;
+    m_active = window->isActiveWindow();
+    window->installEventFilter(this);
+    updateTheme();
+    addWidget(window, Role::WindowBackground);
+    connect(ThemeChangeNotifier::instance(), &ThemeChangeNotifier::themeChanged, this, &ThemeApplier::updateTheme);
+}
+
+ThemeApplier::~ThemeApplier()
+{
+}
+
+void ThemeApplier::addWidget(QWidget *widget, const Role role)
+{
+    Q_ASSERT(widget);
+    if (!widget) {
+        return;
+    }
+    removeWidget(widget);
+    m_widgets[static_cast<int>(role)].append(widget);
+    applyColor(widget, role, m_colors[static_cast<int>(role)]);
+}
+
+void ThemeApplier::removeWidget(QWidget *widget)
+{
+    Q_ASSERT(widget);
+    if (!widget) {
+        return;
+    }
+    for (auto &&widgets : m_widgets) {
+        widgets.removeAll(widget);
+    }
+}
+
+bool ThemeApplier::isDarkMode() const
+{
+    return m_dark;
+}
+
+bool ThemeApplier::isActive() const
+{
+    return m_active;
+}
+
+QColor ThemeApplier::color(const Role role) const
+{
+    return m_colors[static_cast<int>(role)];
+}
+
+void ThemeApplier::updateTheme()
+{
+    // The only place where the system is asked, everything else works on the cache.
+    const ColorizationArea area = Utilities::getColorizationArea();
+    const bool dark = Utilities::shouldAppsUseDarkMode();
+    const bool darkChanged = (m_dark != dark);
+    m_dark = dark;
+    m_colorizedTitleBar = ((area == ColorizationArea::TitleBar_WindowBorder) || (area == ColorizationArea::All));
+    m_colorizationColor = Utilities::getColorizationColor();
+    updateColors();
+    if (darkChanged) {
+        Q_EMIT darkModeChanged(m_dark);
+    }
+}
+
+bool ThemeApplier::eventFilter(QObject *object, QEvent *event)
+{
+    if ((object == m_window.data()) && (event->type() == QEvent::ActivationChange)) {
+        const bool active = m_window->isActiveWindow();
+        if (m_active != active) {
+            m_active = active;
+            updateColors();
+        }
+    }
+    return QObject::eventFilter(object, event);
+}
+
+bool ThemeApplier::applyRole(const Role role, const QColor &value)
+{
+    QColor &current = m_colors[static_cast<int>(role)];
+    if (current == value) {
+        return false;
+    }
+    current = value;
+    QList<QPointer<QWidget>> &widgets = m_widgets[static_cast<int>(role)];
+    widgets.removeAll(QPointer<QWidget>());
+    for (auto &&widget : qAsConst(widgets)) {
+        applyColor(widget, role, value);
+    }
+    return true;
+}
+
+void ThemeApplier::applyColor(QWidget *widget, const Role role, const QColor &value)
+{
+    Q_ASSERT(widget);
+    if (!widget || !value.isValid()) {
+        return;
+    }
+    const QPalette::ColorRole paletteRole = getPaletteRole(role);
+    if ((paletteRole == QPalette::Window) && !widget->isWindow()) {
+        widget->setAutoFillBackground(true);
+    }
+    QPalette palette = widget->palette();
+    if (palette.color(paletteRole) == value) {
+        return;
+    }
+    // Set for all the color groups, the activation state is already part of the value.
+    palette.setColor(paletteRole, value);
+    widget->setPalette(palette);
+}
+
+void ThemeApplier::updateColors()
+{
+    bool changed = applyRole(Role::WindowBackground, (m_dark ? kSystemDarkColor : kSystemLightColor));
+    changed |= applyRole(Role::TitleBarBackground, [this]() -> QColor {
+        if (m_active) {
+            if (m_colorizedTitleBar) {
+                return m_colorizationColor;
+            }
+            return (m_dark ? Qt::black : Qt::white);
+        }
+        return (m_dark ? kSystemDarkColor : QColor(Qt::white));
+    }());
+    changed |= applyRole(Role::TitleBarText, (m_active ? (m_dark ? Qt::white : Qt::black) : Qt::darkGray));
+    changed |= applyRole(Role::Text, (m_dark ? Qt::white : Qt::black));
+    if (changed) {
+        Q_EMIT themeChanged();
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
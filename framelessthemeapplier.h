@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qlist.h>
+#include <QtCore/qpointer.h>
+#include <QtGui/qcolor.h>
+#include <QtWidgets/qwidget.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Keeps the colors of a frameless window and its custom title bar in sync with
+// the system theme (dark mode, colorization color) and the activation state of
+// the window. The colors are applied through QPalette, and only the roles whose
+// color really changed are touched, so switching the focus between windows
+// doesn't force the whole widget tree to be repolished like setStyleSheet() does.
+class FRAMELESSHELPER_WIDGETS_API ThemeApplier : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ThemeApplier)
+
+public:
+    enum class Role : int
+    {
+        WindowBackground = 0,
+        TitleBarBackground,
+        TitleBarText,
+        Text
+    };
+    Q_ENUM(Role)
+
+    explicit ThemeApplier(QWidget *window);
+    ~ThemeApplier() override;
+
+    void addWidget(QWidget *widget, const Role role);
+    void removeWidget(QWidget *widget);
+
+    Q_NODISCARD bool isDarkMode() const;
+    Q_NODISCARD bool isActive() const;
+    Q_NODISCARD QColor color(const Role role) const;
+
+public Q_SLOTS:
+    void updateTheme();
+
+Q_SIGNALS:
+    // Only emitted if at least one of the colors really changed.
+    void themeChanged();
+    // Only emitted by updateTheme(), never for activation changes.
+    void darkModeChanged(bool dark);
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    static constexpr int kRoleCount = 4;
+
+    [[nodiscard]] bool applyRole(const Role role, const QColor &value);
+    static void applyColor(QWidget *widget, const Role role, const QColor &value);
+    void updateColors();
+
+private:
+    QPointer<QWidget> m_window = nullptr;
+    bool m_dark = false;
+    bool m_colorizedTitleBar = false;
+    QColor m_colorizationColor = {};
+    bool m_active = false;
+    QList<QPointer<QWidget>> m_widgets[kRoleCount] = {};
+    QColor m_colors[kRoleCount] = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
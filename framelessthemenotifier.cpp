@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessthemenotifier.h"
+#include "utilities.h"
+#include <QtCore/qdebug.h>
+#include <QtCore/qcoreapplication.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(ThemeChangeNotifier, g_themeChangeNotifier)
+
+ThemeChangeNotifier::ThemeChangeNotifier(QObject *parent) : QObject(parent)
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    Q_ASSERT(app);
+    if (!app) {
+        qWarning() << "ThemeChangeNotifier needs a QCoreApplication instance.";
+        return;
+    }
+    app->installNativeEventFilter(this);
+}
+
+ThemeChangeNotifier::~ThemeChangeNotifier()
+{
+    // The global instance may outlive the application object.
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        app->removeNativeEventFilter(this);
+    }
+}
+
+ThemeChangeNotifier *ThemeChangeNotifier::instance()
+{
+    return g_themeChangeNotifier();
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool ThemeChangeNotifier::nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result)
+#else
+bool ThemeChangeNotifier::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+#endif
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(result);
+    if (message && Utilities::isThemeChanged(message)) {
+        Q_EMIT themeChanged();
+    }
+    return false;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qabstractnativeeventfilter.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The only native event filter which looks for system theme changes (dark mode,
+// colorization color, accent color). Everything that caches theme dependent
+// values connects to themeChanged() instead of installing a filter of its own,
+// so each native event is only inspected once no matter how many title bars and
+// borders are alive.
+class FRAMELESSHELPER_API ThemeChangeNotifier : public QObject, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ThemeChangeNotifier)
+
+public:
+    explicit ThemeChangeNotifier(QObject *parent = nullptr);
+    ~ThemeChangeNotifier() override;
+
+    // Shared by the whole application, needs a QCoreApplication instance.
+    [[nodiscard]] static ThemeChangeNotifier *instance();
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override;
+#else
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+#endif
+
+Q_SIGNALS:
+    void themeChanged();
+};
+
+FRAMELESSHELPER_END_NAMESPACE
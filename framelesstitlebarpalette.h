@@ -0,0 +1,43 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtGui/qcolor.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The colors of the title bars drawn by the library, shared by the Qt Widgets and
+// the Qt Quick title bar and the theme applier, so that they all look the same.
+
+inline const QColor kSystemLightColor = QColor::fromRgb(0xf0, 0xf0, 0xf0);
+inline const QColor kSystemDarkColor = QColor::fromRgb(32, 32, 32);
+
+inline const QColor kButtonHoverColor = QColor::fromRgb(0xc7, 0xc7, 0xc7);
+inline const QColor kButtonPressColor = QColor::fromRgb(0x80, 0x80, 0x80);
+inline const QColor kCloseButtonHoverColor = QColor::fromRgb(0xe8, 0x11, 0x23);
+inline const QColor kCloseButtonPressColor = QColor::fromRgb(0x8c, 0x0a, 0x15);
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,206 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesstracer.h"
+#include <QtCore/qdebug.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qcoreapplication.h>
+#include <atomic>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr const quint64 kRingBufferCapacity = 4096;
+
+// Only the owning thread writes into its buffer, so recording never takes a
+// lock. The slots are atomics because dump() may read them concurrently.
+struct TraceEvent
+{
+    std::atomic<const char *> name{nullptr};
+    std::atomic<qint64> timestamp{0};
+    std::atomic<bool> begin{false};
+};
+
+struct TraceRingBuffer
+{
+    quint64 threadId = 0;
+    std::atomic<quint64> head{0};
+    TraceEvent events[kRingBufferCapacity];
+};
+
+struct TracerData
+{
+    explicit TracerData()
+    {
+        clock.start();
+    }
+
+    QElapsedTimer clock = {};
+    QMutex mutex;
+    // Kept until exit, the spans of finished threads are still worth dumping.
+    QList<QSharedPointer<TraceRingBuffer>> buffers = {};
+    QString dumpFileOnExit = {};
+    bool postRoutineAdded = false;
+};
+
+Q_GLOBAL_STATIC(TracerData, g_tracerData)
+
+std::atomic<bool> Tracer::g_tracerEnabled{false};
+
+static thread_local TraceRingBuffer *t_ringBuffer = nullptr;
+
+[[nodiscard]] static inline TraceRingBuffer *currentRingBuffer()
+{
+    if (t_ringBuffer) {
+        return t_ringBuffer;
+    }
+    // Once per thread.
+    QSharedPointer<TraceRingBuffer> buffer(new TraceRingBuffer);
+    buffer->threadId = static_cast<quint64>(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    QMutexLocker locker(&g_tracerData()->mutex);
+    g_tracerData()->buffers.append(buffer);
+    t_ringBuffer = buffer.data();
+    return t_ringBuffer;
+}
+
+static inline void recordEvent(const char *name, const bool begin)
+{
+    Q_ASSERT(name);
+    if (!name || g_tracerData.isDestroyed()) {
+        return;
+    }
+    TraceRingBuffer *buffer = currentRingBuffer();
+    const quint64 index = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer->events[index % kRingBufferCapacity];
+    event.name.store(name, std::memory_order_relaxed);
+    event.timestamp.store(g_tracerData()->clock.nsecsElapsed(), std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    buffer->head.store((index + 1), std::memory_order_release);
+}
+
+static inline void dumpOnExit()
+{
+    QString fileName = {};
+    {
+        QMutexLocker locker(&g_tracerData()->mutex);
+        fileName = g_tracerData()->dumpFileOnExit;
+    }
+    if (!fileName.isEmpty()) {
+        static_cast<void>(Tracer::dump(fileName));
+    }
+}
+
+void Tracer::setEnabled(const bool value)
+{
+    g_tracerEnabled.store(value, std::memory_order_relaxed);
+}
+
+void Tracer::beginSpan(const char *name)
+{
+    recordEvent(name, true);
+}
+
+void Tracer::endSpan(const char *name)
+{
+    recordEvent(name, false);
+}
+
+bool Tracer::dump(const QString &fileName)
+{
+    Q_ASSERT(!fileName.isEmpty());
+    if (fileName.isEmpty()) {
+        return false;
+    }
+    QList<QSharedPointer<TraceRingBuffer>> buffers = {};
+    {
+        QMutexLocker locker(&g_tracerData()->mutex);
+        buffers = g_tracerData()->buffers;
+    }
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events = {};
+    for (auto &&buffer : qAsConst(buffers)) {
+        const quint64 head = buffer->head.load(std::memory_order_acquire);
+        const quint64 first = ((head > kRingBufferCapacity) ? (head - kRingBufferCapacity) : 0);
+        QJsonArray threadEvents = {};
+        quint64 index = first;
+        for (; index != head; ++index) {
+            const TraceEvent &event = buffer->events[index % kRingBufferCapacity];
+            const char *name = event.name.load(std::memory_order_relaxed);
+            if (!name) {
+                continue;
+            }
+            QJsonObject object = {};
+            object.insert(QStringLiteral("name"), QString::fromLatin1(name));
+            object.insert(QStringLiteral("cat"), QStringLiteral("framelesshelper"));
+            object.insert(QStringLiteral("ph"), (event.begin.load(std::memory_order_relaxed) ? QStringLiteral("B") : QStringLiteral("E")));
+            // Microseconds.
+            object.insert(QStringLiteral("ts"), (static_cast<qreal>(event.timestamp.load(std::memory_order_relaxed)) / 1000.0));
+            object.insert(QStringLiteral("pid"), pid);
+            object.insert(QStringLiteral("tid"), static_cast<qint64>(buffer->threadId));
+            threadEvents.append(object);
+        }
+        // The owning thread may have kept recording in the mean time and
+        // overwritten the oldest slots we have just read, one more slot may
+        // be in the middle of being written. The fence keeps the slot reads
+        // above from being reordered after the head load below.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 newHead = (buffer->head.load(std::memory_order_relaxed) + 1);
+        const quint64 overwritten = (((newHead - first) > kRingBufferCapacity) ? (newHead - first - kRingBufferCapacity) : 0);
+        for (int i = static_cast<int>(qMin(overwritten, static_cast<quint64>(threadEvents.size()))); i < threadEvents.size(); ++i) {
+            events.append(threadEvents.at(i));
+        }
+    }
+    QJsonObject root = {};
+    root.insert(QStringLiteral("traceEvents"), events);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Failed to open" << fileName << "for the trace:" << file.errorString();
+        return false;
+    }
+    const QByteArray data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    if (file.write(data) != data.size()) {
+        qWarning() << "Failed to write the trace:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void Tracer::setDumpFileOnExit(const QString &fileName)
+{
+    QMutexLocker locker(&g_tracerData()->mutex);
+    g_tracerData()->dumpFileOnExit = fileName;
+    if (!g_tracerData()->postRoutineAdded && !fileName.isEmpty()) {
+        qAddPostRoutine(dumpOnExit);
+        g_tracerData()->postRoutineAdded = true;
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
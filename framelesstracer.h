@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <atomic>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Records begin/end spans of the frameless window operations and exports them
+// in the Chrome trace event format, which can be loaded into Perfetto or
+// chrome://tracing. Disabled by default, a disabled tracer only costs a relaxed
+// atomic load per span.
+namespace Tracer
+{
+
+// Not part of the API, use setEnabled() and isEnabled() instead. A plain
+// atomic so that the check is inlined into every span and stays valid during
+// the static destruction.
+extern FRAMELESSHELPER_API std::atomic<bool> g_tracerEnabled;
+
+FRAMELESSHELPER_API void setEnabled(const bool value);
+
+[[nodiscard]] inline bool isEnabled()
+{
+    return g_tracerEnabled.load(std::memory_order_relaxed);
+}
+
+// Writes the spans which are still in the ring buffers, the oldest ones are
+// overwritten once a thread has recorded more than the buffer can hold.
+[[nodiscard]] FRAMELESSHELPER_API bool dump(const QString &fileName);
+// Also dump the trace when the application quits. Pass an empty string to
+// cancel it.
+FRAMELESSHELPER_API void setDumpFileOnExit(const QString &fileName);
+
+// The name must be a string literal, only the pointer is stored.
+FRAMELESSHELPER_API void beginSpan(const char *name);
+FRAMELESSHELPER_API void endSpan(const char *name);
+
+class TraceScope
+{
+    Q_DISABLE_COPY_MOVE(TraceScope)
+
+public:
+    explicit TraceScope(const char *name) : m_name(isEnabled() ? name : nullptr)
+    {
+        if (m_name) {
+            beginSpan(m_name);
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (m_name) {
+            endSpan(m_name);
+        }
+    }
+
+private:
+    const char *m_name = nullptr;
+};
+
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#define FRAMELESSHELPER_TRACE_SCOPE(name) \
+    const FRAMELESSHELPER_PREPEND_NAMESPACE(Tracer)::TraceScope framelessHelperTraceScope(name)
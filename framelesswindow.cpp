@@ -0,0 +1,488 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesswindow.h"
+#include <QtCore/qdebug.h>
+#include <QtCore/qvariant.h>
+#include <QtGui/qevent.h>
+#include "utilities.h"
+#include "framelessstatistics.h"
+#include "framelesstracer.h"
+#include "framelesshittesttable.h"
+#ifndef FRAMELESSHELPER_USE_UNIX_VERSION
+#include "framelesshelper_win32.h"
+#include "framelesshelper_windows.h"
+#endif
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+[[nodiscard]] static inline QPointF getLocalPosition(const QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return {};
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    return event->position();
+#else
+    return event->localPos();
+#endif
+}
+
+[[nodiscard]] static inline Qt::Edges getEdges(const FramelessWindowBase::HitTestResult result)
+{
+    switch (result) {
+    case FramelessWindowBase::HitTestResult::Left:
+        return Qt::Edges{Qt::LeftEdge};
+    case FramelessWindowBase::HitTestResult::Top:
+        return Qt::Edges{Qt::TopEdge};
+    case FramelessWindowBase::HitTestResult::Right:
+        return Qt::Edges{Qt::RightEdge};
+    case FramelessWindowBase::HitTestResult::Bottom:
+        return Qt::Edges{Qt::BottomEdge};
+    case FramelessWindowBase::HitTestResult::TopLeft:
+        return (Qt::TopEdge | Qt::LeftEdge);
+    case FramelessWindowBase::HitTestResult::TopRight:
+        return (Qt::TopEdge | Qt::RightEdge);
+    case FramelessWindowBase::HitTestResult::BottomLeft:
+        return (Qt::BottomEdge | Qt::LeftEdge);
+    case FramelessWindowBase::HitTestResult::BottomRight:
+        return (Qt::BottomEdge | Qt::RightEdge);
+    case FramelessWindowBase::HitTestResult::Client:
+    case FramelessWindowBase::HitTestResult::TitleBar:
+        break;
+    }
+    return {};
+}
+#else
+[[nodiscard]] static inline LRESULT getNativeHitTestResult(const FramelessWindowBase::HitTestResult result)
+{
+    switch (result) {
+    case FramelessWindowBase::HitTestResult::Client:
+        break;
+    case FramelessWindowBase::HitTestResult::TitleBar:
+        return HTCAPTION;
+    case FramelessWindowBase::HitTestResult::Left:
+        return HTLEFT;
+    case FramelessWindowBase::HitTestResult::Top:
+        return HTTOP;
+    case FramelessWindowBase::HitTestResult::Right:
+        return HTRIGHT;
+    case FramelessWindowBase::HitTestResult::Bottom:
+        return HTBOTTOM;
+    case FramelessWindowBase::HitTestResult::TopLeft:
+        return HTTOPLEFT;
+    case FramelessWindowBase::HitTestResult::TopRight:
+        return HTTOPRIGHT;
+    case FramelessWindowBase::HitTestResult::BottomLeft:
+        return HTBOTTOMLEFT;
+    case FramelessWindowBase::HitTestResult::BottomRight:
+        return HTBOTTOMRIGHT;
+    }
+    return HTCLIENT;
+}
+#endif
+
+FramelessWindowBase::FramelessWindowBase(QWindow *window) : m_window(window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    Statistics::addWindow(window);
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    window->setFlags(window->flags() | Qt::FramelessWindowHint);
+    // Only for the code which asks FramelessWindowsManager::isWindowFrameless().
+    window->setProperty(Constants::kFramelessModeFlag, true);
+#endif
+}
+
+FramelessWindowBase::~FramelessWindowBase()
+{
+    if (m_window) {
+        Statistics::removeWindow(m_window);
+    }
+}
+
+int FramelessWindowBase::titleBarHeight() const
+{
+    return m_titleBarHeight;
+}
+
+void FramelessWindowBase::setTitleBarHeight(const int value)
+{
+    if (value <= 0) {
+        return;
+    }
+    m_titleBarHeight = value;
+}
+
+int FramelessWindowBase::resizeBorderThickness() const
+{
+    return m_resizeBorderThickness;
+}
+
+void FramelessWindowBase::setResizeBorderThickness(const int value)
+{
+    if (value <= 0) {
+        return;
+    }
+    m_resizeBorderThickness = value;
+    m_resizeBorderThicknessSet = true;
+}
+
+bool FramelessWindowBase::isResizable() const
+{
+    return m_resizable;
+}
+
+void FramelessWindowBase::setResizable(const bool value)
+{
+    m_resizable = value;
+}
+
+void FramelessWindowBase::setHitTestVisible(QObject *object, const bool visible)
+{
+    Q_ASSERT(object);
+    if (!object) {
+        return;
+    }
+    if (!object->isWidgetType() && !object->inherits("QQuickItem")) {
+        qWarning() << object << "is not a QWidget or QQuickItem.";
+        return;
+    }
+    m_hitTestVisibleObjects.removeAll(QPointer<QObject>());
+    if (visible) {
+        if (!m_hitTestVisibleObjects.contains(object)) {
+            m_hitTestVisibleObjects.append(object);
+        }
+    } else {
+        m_hitTestVisibleObjects.removeAll(object);
+    }
+}
+
+FramelessWindowBase::HitTestResult FramelessWindowBase::hitTest(const QPointF &pos) const
+{
+    Q_ASSERT(m_window);
+    if (!m_window) {
+        return HitTestResult::Client;
+    }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(m_window, HitTests);
+    FRAMELESSHELPER_TRACE_SCOPE("hitTest");
+    const Qt::WindowState state = m_window->windowState();
+    if ((state == Qt::WindowNoState) && m_resizable && !Utilities::isWindowFixedSize(m_window)) {
+        const auto thickness = static_cast<qreal>(m_resizeBorderThickness);
+        const bool left = (pos.x() < thickness);
+        const bool right = (pos.x() >= (static_cast<qreal>(m_window->width()) - thickness));
+        const bool top = (pos.y() < thickness);
+        const bool bottom = (pos.y() >= (static_cast<qreal>(m_window->height()) - thickness));
+        if (top) {
+            return (left ? HitTestResult::TopLeft : (right ? HitTestResult::TopRight : HitTestResult::Top));
+        }
+        if (bottom) {
+            return (left ? HitTestResult::BottomLeft : (right ? HitTestResult::BottomRight : HitTestResult::Bottom));
+        }
+        if (left) {
+            return HitTestResult::Left;
+        }
+        if (right) {
+            return HitTestResult::Right;
+        }
+    }
+    if ((pos.y() >= 0.0) && (pos.y() < static_cast<qreal>(m_titleBarHeight)) && !isInsideHitTestVisibleObject(pos)) {
+        return HitTestResult::TitleBar;
+    }
+    return HitTestResult::Client;
+}
+
+bool FramelessWindowBase::isInsideHitTestVisibleObject(const QPointF &pos) const
+{
+    for (auto &&object : qAsConst(m_hitTestVisibleObjects)) {
+        if (!object || !object->property("visible").toBool()) {
+            continue;
+        }
+        const QPointF origin = Utilities::mapOriginPointToWindow(object);
+        const QSizeF size = {object->property("width").toReal(), object->property("height").toReal()};
+        if (QRectF(origin, size).contains(pos)) {
+            return true;
+        }
+    }
+    // The items which registered themselves through FramelessWindowsManager, such as
+    // the title bars of this library, must keep working. Windows without any of
+    // them don't pay for the lookup.
+    if (!m_window->property(Constants::kHitTestVisibleFlag).isValid()
+            && !HitTestTable::hasWindowTables(m_window)) {
+        return false;
+    }
+    return Utilities::isHitTestVisible(m_window);
+}
+
+void FramelessWindowBase::handleWindowEvent(QEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event || (event->type() != QEvent::PlatformSurface)) {
+        return;
+    }
+#ifndef FRAMELESSHELPER_USE_UNIX_VERSION
+    if (static_cast<QPlatformSurfaceEvent *>(event)->surfaceEventType() == QPlatformSurfaceEvent::SurfaceCreated) {
+        // The client area still has to be extended over the whole window, which
+        // needs the shared native event filter, only the hit-testing is done here.
+        FramelessHelperWin::addFramelessWindow(m_window);
+        // Follow the system unless the user has chosen a thickness.
+        if (!m_resizeBorderThicknessSet) {
+            m_resizeBorderThickness = Utilities::getSystemMetric(m_window, SystemMetric::ResizeBorderThickness, false);
+        }
+    }
+#endif
+}
+
+bool FramelessWindowBase::handleMousePressEvent(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    if (event->button() != Qt::LeftButton) {
+        return false;
+    }
+    const HitTestResult result = hitTest(getLocalPosition(event));
+    // The move is started once the pointer really moves, otherwise the window
+    // manager would swallow the second click of a double click.
+    m_titleBarPressed = (result == HitTestResult::TitleBar);
+    if (m_titleBarPressed) {
+        return true;
+    }
+    if (result == HitTestResult::Client) {
+        return false;
+    }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(m_window, SystemResizes);
+    FRAMELESSHELPER_TRACE_SCOPE("startSystemResize");
+    if (!m_window->startSystemResize(getEdges(result))) {
+        // ### FIXME: TO BE IMPLEMENTED!
+        qWarning() << "Current OS doesn't support QWindow::startSystemResize().";
+        return false;
+    }
+    return true;
+#else
+    // The system does all of this for us on Win32, based on WM_NCHITTEST.
+    return false;
+#endif
+}
+
+bool FramelessWindowBase::handleMouseMoveEvent(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    if (m_titleBarPressed && (event->buttons() & Qt::LeftButton)) {
+        m_titleBarPressed = false;
+        FRAMELESSHELPER_STATISTICS_INCREMENT(m_window, SystemMoves);
+        FRAMELESSHELPER_TRACE_SCOPE("startSystemMove");
+        if (!m_window->startSystemMove()) {
+            // ### FIXME: TO BE IMPLEMENTED!
+            qWarning() << "Current OS doesn't support QWindow::startSystemMove().";
+            return false;
+        }
+        return true;
+    }
+    updateCursor(hitTest(getLocalPosition(event)));
+    return false;
+#else
+    return false;
+#endif
+}
+
+bool FramelessWindowBase::handleMouseReleaseEvent(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return false;
+    }
+    if (event->button() == Qt::LeftButton) {
+        m_titleBarPressed = false;
+    }
+    return false;
+}
+
+bool FramelessWindowBase::handleMouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    if ((event->button() != Qt::LeftButton) || (hitTest(getLocalPosition(event)) != HitTestResult::TitleBar)) {
+        return false;
+    }
+    m_titleBarPressed = false;
+    toggleMaximized();
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool FramelessWindowBase::handleNativeEvent(const QByteArray &eventType, void *message, qintptr *result)
+#else
+bool FramelessWindowBase::handleNativeEvent(const QByteArray &eventType, void *message, long *result)
+#endif
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    Q_UNUSED(eventType);
+    Q_UNUSED(message);
+    Q_UNUSED(result);
+    return false;
+#else
+    if ((eventType != QByteArrayLiteral("windows_generic_MSG")) || !message || !result) {
+        return false;
+    }
+#if (QT_VERSION == QT_VERSION_CHECK(5, 11, 1))
+    const auto msg = *reinterpret_cast<MSG **>(message);
+#else
+    const auto msg = static_cast<LPMSG>(message);
+#endif
+    // The shared native event filter leaves this message to us.
+    if (!msg->hwnd || (msg->message != WM_NCHITTEST)) {
+        return false;
+    }
+    POINT nativePos = {GET_X_LPARAM(msg->lParam), GET_Y_LPARAM(msg->lParam)};
+    if (ScreenToClient(msg->hwnd, &nativePos) == FALSE) {
+        qWarning() << Utilities::getSystemErrorMessage(QStringLiteral("ScreenToClient"));
+        return false;
+    }
+    const QPointF pos = (QPointF(static_cast<qreal>(nativePos.x), static_cast<qreal>(nativePos.y)) / m_window->devicePixelRatio());
+    *result = getNativeHitTestResult(hitTest(pos));
+    return true;
+#endif
+}
+
+void FramelessWindowBase::toggleMaximized()
+{
+    const Qt::WindowState state = m_window->windowState();
+    if (state == Qt::WindowFullScreen) {
+        return;
+    }
+    if (state == Qt::WindowMaximized) {
+        m_window->showNormal();
+    } else {
+        m_window->showMaximized();
+    }
+}
+
+void FramelessWindowBase::updateCursor(const HitTestResult result)
+{
+    switch (result) {
+    case HitTestResult::TopLeft:
+    case HitTestResult::BottomRight:
+        m_window->setCursor(Qt::SizeFDiagCursor);
+        break;
+    case HitTestResult::TopRight:
+    case HitTestResult::BottomLeft:
+        m_window->setCursor(Qt::SizeBDiagCursor);
+        break;
+    case HitTestResult::Top:
+    case HitTestResult::Bottom:
+        m_window->setCursor(Qt::SizeVerCursor);
+        break;
+    case HitTestResult::Left:
+    case HitTestResult::Right:
+        m_window->setCursor(Qt::SizeHorCursor);
+        break;
+    case HitTestResult::Client:
+    case HitTestResult::TitleBar:
+        if (m_cursorChanged) {
+            m_window->unsetCursor();
+            FRAMELESSHELPER_STATISTICS_INCREMENT(m_window, CursorChanges);
+            m_cursorChanged = false;
+        }
+        return;
+    }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(m_window, CursorChanges);
+    m_cursorChanged = true;
+}
+
+FramelessWindow::FramelessWindow(QWindow *parent) : QWindow(parent), FramelessWindowBase(this) {}
+
+FramelessWindow::~FramelessWindow() = default;
+
+bool FramelessWindow::event(QEvent *event)
+{
+    handleWindowEvent(event);
+    return QWindow::event(event);
+}
+
+void FramelessWindow::mousePressEvent(QMouseEvent *event)
+{
+    if (handleMousePressEvent(event)) {
+        event->accept();
+        return;
+    }
+    QWindow::mousePressEvent(event);
+}
+
+void FramelessWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    if (handleMouseMoveEvent(event)) {
+        event->accept();
+        return;
+    }
+    QWindow::mouseMoveEvent(event);
+}
+
+void FramelessWindow::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (handleMouseReleaseEvent(event)) {
+        event->accept();
+        return;
+    }
+    QWindow::mouseReleaseEvent(event);
+}
+
+void FramelessWindow::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (handleMouseDoubleClickEvent(event)) {
+        event->accept();
+        return;
+    }
+    QWindow::mouseDoubleClickEvent(event);
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool FramelessWindow::nativeEvent(const QByteArray &eventType, void *message, qintptr *result)
+#else
+bool FramelessWindow::nativeEvent(const QByteArray &eventType, void *message, long *result)
+#endif
+{
+    if (handleNativeEvent(eventType, message, result)) {
+        return true;
+    }
+    return QWindow::nativeEvent(eventType, message, result);
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qlist.h>
+#include <QtCore/qpointer.h>
+#include <QtGui/qwindow.h>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QMouseEvent)
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The frameless behavior for windows which are created by the application itself.
+// Unlike FramelessWindowsManager::addWindow(), nothing is attached from outside:
+// the window handles its own input events and keeps its settings in member
+// variables, so no event filter and no dynamic property is involved in the hot
+// paths. Override hitTest() to describe the window layout directly.
+class FRAMELESSHELPER_API FramelessWindowBase
+{
+    Q_DISABLE_COPY_MOVE(FramelessWindowBase)
+
+public:
+    enum class HitTestResult : int
+    {
+        Client = 0,
+        TitleBar,
+        Left,
+        Top,
+        Right,
+        Bottom,
+        TopLeft,
+        TopRight,
+        BottomLeft,
+        BottomRight
+    };
+
+    explicit FramelessWindowBase(QWindow *window);
+    virtual ~FramelessWindowBase();
+
+    [[nodiscard]] int titleBarHeight() const;
+    void setTitleBarHeight(const int value);
+
+    [[nodiscard]] int resizeBorderThickness() const;
+    void setResizeBorderThickness(const int value);
+
+    [[nodiscard]] bool isResizable() const;
+    void setResizable(const bool value);
+
+    void setHitTestVisible(QObject *object, const bool visible = true);
+
+    // The position is in the window's coordinate system, in device independent pixels.
+    [[nodiscard]] virtual HitTestResult hitTest(const QPointF &pos) const;
+
+protected:
+    void handleWindowEvent(QEvent *event);
+    [[nodiscard]] bool handleMousePressEvent(QMouseEvent *event);
+    [[nodiscard]] bool handleMouseMoveEvent(QMouseEvent *event);
+    [[nodiscard]] bool handleMouseReleaseEvent(QMouseEvent *event);
+    [[nodiscard]] bool handleMouseDoubleClickEvent(QMouseEvent *event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    [[nodiscard]] bool handleNativeEvent(const QByteArray &eventType, void *message, qintptr *result);
+#else
+    [[nodiscard]] bool handleNativeEvent(const QByteArray &eventType, void *message, long *result);
+#endif
+
+    [[nodiscard]] bool isInsideHitTestVisibleObject(const QPointF &pos) const;
+
+private:
+    void toggleMaximized();
+    void updateCursor(const HitTestResult result);
+
+private:
+    QWindow *m_window = nullptr;
+    int m_titleBarHeight = 31;
+    int m_resizeBorderThickness = 8;
+    bool m_resizeBorderThicknessSet = false;
+    bool m_resizable = true;
+    bool m_titleBarPressed = false;
+    bool m_cursorChanged = false;
+    QList<QPointer<QObject>> m_hitTestVisibleObjects = {};
+};
+
+class FRAMELESSHELPER_API FramelessWindow : public QWindow, public FramelessWindowBase
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FramelessWindow)
+
+public:
+    explicit FramelessWindow(QWindow *parent = nullptr);
+    ~FramelessWindow() override;
+
+protected:
+    bool event(QEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    bool nativeEvent(const QByteArray &eventType, void *message, qintptr *result) override;
+#else
+    bool nativeEvent(const QByteArray &eventType, void *message, long *result) override;
+#endif
+};
+
+FRAMELESSHELPER_END_NAMESPACE
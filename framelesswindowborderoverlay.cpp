@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesswindowborderoverlay.h"
+#include "framelessthemenotifier.h"
+#include "utilities.h"
+#include <QtGui/qevent.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+WindowBorderOverlay::WindowBorderOverlay(QWidget *window) : QWidget(window)
+{
+    Q_ASSERT(window);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::NoFocus);
+    m_window = window;
+    if (m_window) {
+        m_window->installEventFilter(this);
+    }
+    updateTheme();
+    attachToWindow();
+    connect(ThemeChangeNotifier::instance(), &ThemeChangeNotifier::themeChanged, this, &WindowBorderOverlay::updateTheme);
+}
+
+WindowBorderOverlay::~WindowBorderOverlay()
+{
+}
+
+int WindowBorderOverlay::borderThickness() const
+{
+    return m_borderThickness;
+}
+
+QColor WindowBorderOverlay::borderColor() const
+{
+    if (m_window && !m_window->isActiveWindow()) {
+        return Qt::darkGray;
+    }
+    return (m_colorizedBorder ? m_colorizationColor : Qt::black);
+}
+
+void WindowBorderOverlay::updateTheme()
+{
+    const ColorizationArea area = Utilities::getColorizationArea();
+    m_colorizedBorder = ((area == ColorizationArea::TitleBar_WindowBorder) || (area == ColorizationArea::All));
+    m_colorizationColor = Utilities::getColorizationColor();
+    updateBorderThickness();
+    update();
+}
+
+bool WindowBorderOverlay::eventFilter(QObject *object, QEvent *event)
+{
+    if (object == m_window.data()) {
+        switch (event->type()) {
+        case QEvent::Resize:
+        case QEvent::WindowStateChange:
+            updateGeometryAndMask();
+            break;
+        case QEvent::ActivationChange:
+            // Only the border strips are invalidated, thanks to the mask.
+            update();
+            break;
+        case QEvent::ChildAdded:
+            // Stay on top of the content, which may be created after us.
+            raise();
+            break;
+        case QEvent::WinIdChange:
+        case QEvent::Show:
+            attachToWindow();
+            break;
+        default:
+            break;
+        }
+    }
+    return QWidget::eventFilter(object, event);
+}
+
+void WindowBorderOverlay::paintEvent(QPaintEvent *event)
+{
+    const QRegion &dirty = event->region();
+    const QColor color = borderColor();
+    QPainter painter(this);
+    for (auto &&rect : qAsConst(m_borderRects)) {
+        if (dirty.intersects(rect)) {
+            painter.fillRect(rect, color);
+        }
+    }
+}
+
+void WindowBorderOverlay::attachToWindow()
+{
+    QWindow *handle = (m_window ? m_window->windowHandle() : nullptr);
+    if (handle == m_windowHandle.data()) {
+        updateGeometryAndMask();
+        return;
+    }
+    if (m_windowHandle) {
+        disconnect(m_windowHandle, nullptr, this, nullptr);
+    }
+    m_windowHandle = handle;
+    if (m_windowHandle) {
+        connect(m_windowHandle, &QWindow::screenChanged, this, [this](){
+            updateBorderThickness();
+            updateGeometryAndMask();
+        });
+    }
+    updateBorderThickness();
+    updateGeometryAndMask();
+}
+
+void WindowBorderOverlay::updateBorderThickness()
+{
+    if (!m_window || !m_window->internalWinId()) {
+        return;
+    }
+    m_borderThickness = qMax(1, Utilities::getWindowVisibleFrameBorderThickness(m_window->winId()));
+}
+
+void WindowBorderOverlay::updateGeometryAndMask()
+{
+    if (!m_window) {
+        return;
+    }
+    const Qt::WindowStates states = m_window->windowState();
+    if ((states & Qt::WindowMaximized) || (states & Qt::WindowFullScreen)) {
+        hide();
+        return;
+    }
+    const QSize size = m_window->size();
+    const int w = size.width();
+    const int h = size.height();
+    const int t = qMin(m_borderThickness, (qMin(w, h) / 2));
+    m_borderRects[0] = {0, 0, w, t};
+    m_borderRects[1] = {(w - t), t, t, (h - (t * 2))};
+    m_borderRects[2] = {0, (h - t), w, t};
+    m_borderRects[3] = {0, t, t, (h - (t * 2))};
+    QRegion mask = {};
+    for (auto &&rect : qAsConst(m_borderRects)) {
+        mask += rect;
+    }
+    setGeometry(QRect(QPoint(0, 0), size));
+    setMask(mask);
+    raise();
+    show();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
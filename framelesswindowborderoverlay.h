@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qpointer.h>
+#include <QtGui/qcolor.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qwidget.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Draws the visible frame border of a frameless top level widget. It's a child
+// widget masked to the four border strips and transparent for mouse events, so
+// it's only asked to paint when the dirty region of the window really touches the
+// border, and repainting the content of the window never goes through it. The
+// theme colors and the border thickness are cached and only queried again when
+// the system theme or the screen changes.
+class FRAMELESSHELPER_WIDGETS_API WindowBorderOverlay : public QWidget
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(WindowBorderOverlay)
+
+public:
+    explicit WindowBorderOverlay(QWidget *window);
+    ~WindowBorderOverlay() override;
+
+    Q_NODISCARD int borderThickness() const;
+    Q_NODISCARD QColor borderColor() const;
+
+public Q_SLOTS:
+    void updateTheme();
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void attachToWindow();
+    void updateBorderThickness();
+    void updateGeometryAndMask();
+
+private:
+    QPointer<QWidget> m_window = nullptr;
+    QPointer<QWindow> m_windowHandle = nullptr;
+    int m_borderThickness = 1;
+    bool m_colorizedBorder = false;
+    QColor m_colorizationColor = {};
+    // In our own coordinate system, which is the same as the window's.
+    QRect m_borderRects[4] = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -30,9 +30,11 @@
 #ifdef FRAMELESSHELPER_USE_UNIX_VERSION
 #include "framelesshelper.h"
 #else
-#include <QtGui/qscreen.h>
 #include "framelesshelper_win32.h"
+#include "framelessframepacer.h"
 #endif
+#include "framelessscreenwatcher.h"
+#include "framelesstracer.h"
 #include "utilities.h"
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -41,12 +43,34 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 Q_GLOBAL_STATIC(FramelessHelper, framelessHelperUnix)
 #endif
 
+static inline void applyScreenMetrics(QWindow *window, const ScreenDpiWatcher::Changes changes)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    Q_UNUSED(changes);
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    // Nothing to do, the window mask is in device independent pixels and Qt
+    // scales it to the new device pixel ratio by itself.
+#else
+    // Let WM_NCCALCSIZE pick up the metrics of the new DPI, the client area
+    // doesn't need to be laid out again.
+    if (window->handle()) {
+        Utilities::triggerFrameChange(window->winId());
+    }
+#endif
+}
+
+Q_GLOBAL_STATIC_WITH_ARGS(ScreenDpiWatcher, g_screenDpiWatcher, (applyScreenMetrics))
+
 void FramelessWindowsManager::addWindow(QWindow *window)
 {
     Q_ASSERT(window);
     if (!window) {
         return;
     }
+    FRAMELESSHELPER_TRACE_SCOPE("addWindow");
     if (!QCoreApplication::testAttribute(Qt::AA_DontCreateNativeWidgetSiblings)) {
         QCoreApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
     }
@@ -54,12 +78,9 @@ void FramelessWindowsManager::addWindow(QWindow *window)
     framelessHelperUnix()->removeWindowFrame(window);
 #else
     FramelessHelperWin::addFramelessWindow(window);
-    // Work-around a Win32 multi-monitor bug.
-    QObject::connect(window, &QWindow::screenChanged, [window](QScreen *screen){
-        Q_UNUSED(screen);
-        window->resize(window->size());
-    });
 #endif
+    g_screenDpiWatcher()->addWindow(window);
+    Statistics::addWindow(window);
 }
 
 void FramelessWindowsManager::setHitTestVisible(QWindow *window, QObject *object, const bool value)
@@ -158,12 +179,154 @@ void FramelessWindowsManager::setResizable(QWindow *window, const bool value)
 #endif
 }
 
+qreal FramelessWindowsManager::getCornerRadius(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return 0.0;
+    }
+    const qreal value = window->property(Constants::kCornerRadiusFlag).toReal();
+    return value <= 0.0 ? 0.0 : value;
+}
+
+void FramelessWindowsManager::setCornerRadius(QWindow *window, const qreal value)
+{
+    Q_ASSERT(window);
+    if (!window || (value < 0.0)) {
+        return;
+    }
+    window->setProperty(Constants::kCornerRadiusFlag, value);
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    framelessHelperUnix()->updateWindowMask(window);
+#else
+    // Masking the window would break the frame shadow drawn by DWM, so we don't
+    // apply any mask on Win32.
+#endif
+}
+
+bool FramelessWindowsManager::getInputCoalescing(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    return window->property(Constants::kInputCoalescingFlag).toBool();
+}
+
+void FramelessWindowsManager::setInputCoalescing(QWindow *window, const bool value)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    // Only affects the UNIX version, the hit-testing is done by the system on Win32.
+    window->setProperty(Constants::kInputCoalescingFlag, value);
+}
+
+bool FramelessWindowsManager::getOutlineResize(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    return window->property(Constants::kOutlineResizeFlag).toBool();
+}
+
+void FramelessWindowsManager::setOutlineResize(QWindow *window, const bool value)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    // Only affects the UNIX version, Win32 follows the system wide "Show window
+    // contents while dragging" setting instead.
+    window->setProperty(Constants::kOutlineResizeFlag, value);
+}
+
+FramePacingMode FramelessWindowsManager::getFramePacingMode()
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    return FramePacingMode::Off;
+#else
+    return FramelessHelperWin::framePacer()->mode();
+#endif
+}
+
+void FramelessWindowsManager::setFramePacingMode(const FramePacingMode value)
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    // Only affects the Win32 version, the other platforms don't need this hack.
+    Q_UNUSED(value);
+#else
+    FramelessHelperWin::framePacer()->setMode(value);
+#endif
+}
+
+qint64 FramelessWindowsManager::getFramePacingBlockedTime()
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    return 0;
+#else
+    return FramelessHelperWin::framePacer()->blockedTime();
+#endif
+}
+
+bool FramelessWindowsManager::startMessageTrace(const QString &fileName)
+{
+#ifdef FRAMELESSHELPER_USE_UNIX_VERSION
+    // There are no native messages to record on the other platforms.
+    Q_UNUSED(fileName);
+    return false;
+#else
+    return FramelessHelperWin::startMessageTrace(fileName);
+#endif
+}
+
+void FramelessWindowsManager::stopMessageTrace()
+{
+#ifndef FRAMELESSHELPER_USE_UNIX_VERSION
+    FramelessHelperWin::stopMessageTrace();
+#endif
+}
+
+FramelessStatistics FramelessWindowsManager::statistics()
+{
+    return Statistics::snapshot();
+}
+
+void FramelessWindowsManager::resetStatistics()
+{
+    Statistics::reset();
+}
+
+void FramelessWindowsManager::setTracingEnabled(const bool value)
+{
+    Tracer::setEnabled(value);
+}
+
+bool FramelessWindowsManager::isTracingEnabled()
+{
+    return Tracer::isEnabled();
+}
+
+bool FramelessWindowsManager::dumpTrace(const QString &fileName)
+{
+    return Tracer::dump(fileName);
+}
+
+void FramelessWindowsManager::setTraceDumpFileOnExit(const QString &fileName)
+{
+    Tracer::setDumpFileOnExit(fileName);
+}
+
 void FramelessWindowsManager::removeWindow(QWindow *window)
 {
     Q_ASSERT(window);
     if (!window) {
         return;
     }
+    g_screenDpiWatcher()->removeWindow(window);
+    Statistics::removeWindow(window);
 #ifdef FRAMELESSHELPER_USE_UNIX_VERSION
     framelessHelperUnix()->bringBackWindowFrame(window);
 #else
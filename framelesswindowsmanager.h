@@ -25,6 +25,7 @@
 #pragma once
 
 #include "framelesshelper_global.h"
+#include "framelessstatistics.h"
 
 QT_BEGIN_NAMESPACE
 QT_FORWARD_DECLARE_CLASS(QObject)
@@ -46,6 +47,23 @@ FRAMELESSHELPER_API void setResizeBorderThickness(QWindow *window, const int val
 FRAMELESSHELPER_API void setTitleBarHeight(QWindow *window, const int value);
 [[nodiscard]] FRAMELESSHELPER_API bool getResizable(const QWindow *window);
 FRAMELESSHELPER_API void setResizable(QWindow *window, const bool value = true);
+[[nodiscard]] FRAMELESSHELPER_API qreal getCornerRadius(const QWindow *window);
+FRAMELESSHELPER_API void setCornerRadius(QWindow *window, const qreal value);
+[[nodiscard]] FRAMELESSHELPER_API bool getInputCoalescing(const QWindow *window);
+FRAMELESSHELPER_API void setInputCoalescing(QWindow *window, const bool value = true);
+[[nodiscard]] FRAMELESSHELPER_API bool getOutlineResize(const QWindow *window);
+FRAMELESSHELPER_API void setOutlineResize(QWindow *window, const bool value = true);
+[[nodiscard]] FRAMELESSHELPER_API FramePacingMode getFramePacingMode();
+FRAMELESSHELPER_API void setFramePacingMode(const FramePacingMode value);
+[[nodiscard]] FRAMELESSHELPER_API qint64 getFramePacingBlockedTime();
+[[nodiscard]] FRAMELESSHELPER_API bool startMessageTrace(const QString &fileName);
+FRAMELESSHELPER_API void stopMessageTrace();
+[[nodiscard]] FRAMELESSHELPER_API FramelessStatistics statistics();
+FRAMELESSHELPER_API void resetStatistics();
+FRAMELESSHELPER_API void setTracingEnabled(const bool value);
+[[nodiscard]] FRAMELESSHELPER_API bool isTracingEnabled();
+[[nodiscard]] FRAMELESSHELPER_API bool dumpTrace(const QString &fileName);
+FRAMELESSHELPER_API void setTraceDumpFileOnExit(const QString &fileName);
 
 }
 
@@ -0,0 +1,15 @@
+TEMPLATE = lib
+win32: DLLDESTDIR = $$OUT_PWD/bin
+else: unix: DESTDIR = $$OUT_PWD/bin
+CONFIG += c++17 strict_c++ utf8_source warn_on
+DEFINES += \
+    QT_NO_CAST_FROM_ASCII \
+    QT_NO_CAST_TO_ASCII \
+    QT_NO_KEYWORDS \
+    QT_DEPRECATED_WARNINGS \
+    QT_DISABLE_DEPRECATED_BEFORE=0x060200
+framelesshelper_static {
+    CONFIG += staticlib
+    DEFINES += FRAMELESSHELPER_STATIC
+}
+framelesshelper_statistics: DEFINES += FRAMELESSHELPER_ENABLE_STATISTICS
@@ -1,29 +1,51 @@
-TARGET = $$qtLibraryTarget(FramelessHelper)
-TEMPLATE = lib
-win32: DLLDESTDIR = $$OUT_PWD/bin
-else: unix: DESTDIR = $$OUT_PWD/bin
+TARGET = $$qtLibraryTarget(FramelessHelperCore)
+include($$PWD/lib.pri)
 QT += gui-private
-CONFIG += c++17 strict_c++ utf8_source warn_on
-DEFINES += \
-    QT_NO_CAST_FROM_ASCII \
-    QT_NO_CAST_TO_ASCII \
-    QT_NO_KEYWORDS \
-    QT_DEPRECATED_WARNINGS \
-    QT_DISABLE_DEPRECATED_BEFORE=0x060200 \
-    FRAMELESSHELPER_BUILD_LIBRARY
+DEFINES += FRAMELESSHELPER_BUILD_LIBRARY
 HEADERS += \
     framelesshelper_global.h \
     framelesshelper.h \
     framelesswindowsmanager.h \
+    framelessframesnapshot.h \
+    framelesshittesttable.h \
+    framelessglyphatlas.h \
+    framelesstitlebarpalette.h \
+    framelesswindow.h \
+    framelessframegeometry.h \
+    framelessframepacer.h \
+    framelessmessageidset.h \
+    framelessmessagehandler.h \
+    framelessmessagetrace.h \
+    framelesscaptionupdatecoalescer.h \
+    framelessscreenwatcher.h \
+    framelessstatistics.h \
+    framelesstracer.h \
+    framelessthemenotifier.h \
     utilities.h
 SOURCES += \
     framelesshelper.cpp \
     framelesswindowsmanager.cpp \
+    framelessframesnapshot.cpp \
+    framelesshittesttable.cpp \
+    framelessglyphatlas.cpp \
+    framelesswindow.cpp \
+    framelessframegeometry.cpp \
+    framelessframepacer.cpp \
+    framelessmessagehandler.cpp \
+    framelessmessagetrace.cpp \
+    framelesscaptionupdatecoalescer.cpp \
+    framelessscreenwatcher.cpp \
+    framelessstatistics.cpp \
+    framelesstracer.cpp \
+    framelessthemenotifier.cpp \
     utilities.cpp
-qtHaveModule(quick) {
-    QT += quick
-    HEADERS += framelessquickhelper.h
-    SOURCES += framelessquickhelper.cpp
+unix:!macx {
+    SOURCES += utilities_linux.cpp
+    packagesExist(xcb) {
+        CONFIG += link_pkgconfig
+        PKGCONFIG += xcb
+        DEFINES += FRAMELESSHELPER_HAS_XCB
+    }
 }
 win32 {
     HEADERS += \
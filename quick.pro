@@ -0,0 +1,13 @@
+TARGET = $$qtLibraryTarget(FramelessHelperQuick)
+include($$PWD/lib.pri)
+QT += quick
+DEFINES += FRAMELESSHELPER_QUICK_BUILD_LIBRARY
+HEADERS += \
+    framelessquickhelper.h \
+    framelessquicktitlebar.h \
+    framelessquickwindow.h
+SOURCES += \
+    framelessquickhelper.cpp \
+    framelessquicktitlebar.cpp \
+    framelessquickwindow.cpp
+include($$PWD/core.pri)
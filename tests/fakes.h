@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelessframegeometry.h"
+#include "framelessframepacer.h"
+#include "framelessmessagehandler.h"
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The fakes of the platform interfaces shared by the tests. Each one answers from
+// a state the test owns and changes as it goes, and counts how often it has been
+// asked, so that a test can tell whether something has been looked at.
+
+// Milliseconds as ticks by default, time only moves when the test or sleep() moves it.
+struct FakeClockState
+{
+    qint64 frequency = 1000;
+    qint64 now = 0;
+    qint64 vblank = 0;
+    qint64 period = 16;
+    bool vblankAvailable = true;
+    qint64 slept = 0;
+    int queries = 0;
+};
+
+class FakeClock : public FramePacerClock
+{
+public:
+    explicit FakeClock(FakeClockState *state) : m_state(state) {}
+    ~FakeClock() override = default;
+
+    [[nodiscard]] qint64 frequency() const override
+    {
+        ++m_state->queries;
+        return m_state->frequency;
+    }
+
+    [[nodiscard]] qint64 now() const override
+    {
+        ++m_state->queries;
+        return m_state->now;
+    }
+
+    [[nodiscard]] bool getVBlank(qint64 *vblank, qint64 *period) const override
+    {
+        ++m_state->queries;
+        *vblank = m_state->vblank;
+        *period = m_state->period;
+        return m_state->vblankAvailable;
+    }
+
+    void sleep(const qint64 ticks) override
+    {
+        m_state->now += ticks;
+        m_state->slept += ticks;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(FakeClock)
+
+private:
+    FakeClockState *m_state = nullptr;
+};
+
+// A restored, visible, composited 800x600 window at the origin of the screen by
+// default, with the taskbar auto-hidden at the bottom edge.
+struct FakeWindowState
+{
+    // NativeWindowApi
+    bool maximized = false;
+    qint32 clientX = 0;
+    qint32 clientY = 0;
+    qint32 clientWidth = 800;
+    qint32 clientHeight = 600;
+    quintptr monitor = 1;
+    qint64 defWindowProcResult = 0;
+    // WS_OVERLAPPEDWINDOW | WS_VISIBLE
+    qint64 style = 0x10CF0000;
+    bool dwmComposition = true;
+
+    // NativeWindowHost
+    Qt::WindowState windowState = Qt::WindowNoState;
+    int resizeBorderThickness = 8;
+    int titleBarHeight = 30;
+    bool fixedSize = false;
+    bool hitTestVisible = false;
+    bool ownHitTest = false;
+
+    // ShellStateProvider
+    Qt::Edges autoHideTaskbarEdges = Qt::BottomEdge;
+
+    // Calls of the window interfaces and queries of the shell state.
+    int calls = 0;
+    int shellStateQueries = 0;
+};
+
+class FakeWindowApi : public NativeWindowApi
+{
+public:
+    explicit FakeWindowApi(FakeWindowState *state) : m_state(state) {}
+    ~FakeWindowApi() override = default;
+
+    [[nodiscard]] bool isMaximized(const quintptr window) const override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        return m_state->maximized;
+    }
+
+    [[nodiscard]] bool getClientRect(const quintptr window, NativeRect *rect) const override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        *rect = {0, 0, m_state->clientWidth, m_state->clientHeight};
+        return true;
+    }
+
+    [[nodiscard]] bool screenToClient(const quintptr window, QPoint *pos) const override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        *pos -= QPoint(m_state->clientX, m_state->clientY);
+        return true;
+    }
+
+    [[nodiscard]] quintptr monitorFromWindow(const quintptr window) const override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        return m_state->monitor;
+    }
+
+    [[nodiscard]] qint64 defWindowProc(const quintptr window, const quint32 message, const quint64 wParam, const qint64 lParam) override
+    {
+        Q_UNUSED(window);
+        Q_UNUSED(message);
+        Q_UNUSED(wParam);
+        Q_UNUSED(lParam);
+        ++m_state->calls;
+        return m_state->defWindowProcResult;
+    }
+
+    [[nodiscard]] qint64 getWindowStyle(const quintptr window) const override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        return m_state->style;
+    }
+
+    [[nodiscard]] bool setWindowStyle(const quintptr window, const qint64 style) override
+    {
+        Q_UNUSED(window);
+        ++m_state->calls;
+        m_state->style = style;
+        return true;
+    }
+
+    [[nodiscard]] bool isDwmCompositionAvailable() const override
+    {
+        ++m_state->calls;
+        return m_state->dwmComposition;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(FakeWindowApi)
+
+private:
+    FakeWindowState *m_state = nullptr;
+};
+
+class FakeWindowHost : public NativeWindowHost
+{
+public:
+    explicit FakeWindowHost(FakeWindowState *state) : m_state(state) {}
+    ~FakeWindowHost() override = default;
+
+    [[nodiscard]] const QWindow *window() const override
+    {
+        return nullptr;
+    }
+
+    [[nodiscard]] Qt::WindowState windowState() const override
+    {
+        ++m_state->calls;
+        return m_state->windowState;
+    }
+
+    [[nodiscard]] int resizeBorderThickness() const override
+    {
+        ++m_state->calls;
+        return m_state->resizeBorderThickness;
+    }
+
+    [[nodiscard]] int titleBarHeight() const override
+    {
+        ++m_state->calls;
+        return m_state->titleBarHeight;
+    }
+
+    [[nodiscard]] bool isFixedSize() const override
+    {
+        ++m_state->calls;
+        return m_state->fixedSize;
+    }
+
+    [[nodiscard]] bool isHitTestVisible() const override
+    {
+        ++m_state->calls;
+        return m_state->hitTestVisible;
+    }
+
+    [[nodiscard]] bool hasOwnHitTest() const override
+    {
+        ++m_state->calls;
+        return m_state->ownHitTest;
+    }
+
+    void scheduleUpdate(const int delay) override
+    {
+        Q_UNUSED(delay);
+        ++m_state->calls;
+    }
+
+    void scheduleCaptionUpdate(const int delay) override
+    {
+        Q_UNUSED(delay);
+        ++m_state->calls;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(FakeWindowHost)
+
+private:
+    FakeWindowState *m_state = nullptr;
+};
+
+class FakeShellStateProvider : public ShellStateProvider
+{
+public:
+    explicit FakeShellStateProvider(FakeWindowState *state) : m_state(state) {}
+    ~FakeShellStateProvider() override = default;
+
+    [[nodiscard]] bool isTaskbarAutoHide() const override
+    {
+        ++m_state->shellStateQueries;
+        return (int(m_state->autoHideTaskbarEdges) != 0);
+    }
+
+    [[nodiscard]] Qt::Edges getAutoHideTaskbarEdges(const quintptr monitor) const override
+    {
+        Q_UNUSED(monitor);
+        ++m_state->shellStateQueries;
+        return m_state->autoHideTaskbarEdges;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(FakeShellStateProvider)
+
+private:
+    FakeWindowState *m_state = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtCore/qfile.h>
+#include <QtCore/qtextstream.h>
+#include "messagereplayer.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// Usage: messagereplay <trace file>
+// Prints the latency of the message handling in this process per message type,
+// and how often the replayed answer differs from the recorded one.
+int main(int argc, char *argv[])
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (argc != 2) {
+        err << "Usage: messagereplay <trace file>" << '\n';
+        return 1;
+    }
+    QFile file(QString::fromLocal8Bit(argv[1]));
+    if (!file.open(QFile::ReadOnly)) {
+        err << "Failed to open " << file.fileName() << ": " << file.errorString() << '\n';
+        return 1;
+    }
+    MessageTraceReader reader(&file);
+    if (!reader.isValid()) {
+        err << file.fileName() << " is not a valid message trace." << '\n';
+        return 1;
+    }
+    const QList<MessageTraceStatistics> statistics = MessageReplayer::replay(&reader);
+    out << "message\tcount\thandled\tmean (ns)\tmax (ns)\tmismatches" << '\n';
+    for (auto &&entry : qAsConst(statistics)) {
+        const qint64 mean = ((entry.count > 0) ? (entry.totalDuration / static_cast<qint64>(entry.count)) : 0);
+        out << QStringLiteral("0x%1").arg(entry.message, 4, 16, QLatin1Char('0')) << '\t'
+            << entry.count << '\t' << entry.handledCount << '\t'
+            << mean << '\t' << entry.maximumDuration << '\t' << entry.mismatchCount << '\n';
+    }
+    return 0;
+}
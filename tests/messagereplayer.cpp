@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "messagereplayer.h"
+#include <QtCore/qmap.h>
+#include <QtCore/qelapsedtimer.h>
+#include "fakes.h"
+#include "framelesscaptionupdatecoalescer.h"
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The fakes answer what the recorded window answered.
+static inline void applyRecord(const MessageTraceRecord &record, FakeWindowState *window, FakeClockState *clock)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(clock);
+    if (!window || !clock) {
+        return;
+    }
+    window->maximized = record.maximized;
+    window->clientX = record.clientX;
+    window->clientY = record.clientY;
+    window->clientWidth = record.clientWidth;
+    window->clientHeight = record.clientHeight;
+    // Only called by handled messages, which return what the system answered.
+    window->defWindowProcResult = record.result;
+    window->dwmComposition = record.dwmComposition;
+    // The style isn't recorded, every message starts from the default one.
+    window->style = FakeWindowState{}.style;
+    window->windowState = static_cast<Qt::WindowState>(record.windowState);
+    window->resizeBorderThickness = record.resizeBorderThickness;
+    window->titleBarHeight = record.titleBarHeight;
+    window->fixedSize = record.fixedSize;
+    window->hitTestVisible = record.hitTestVisible;
+    window->ownHitTest = record.ownHitTest;
+    window->autoHideTaskbarEdges = Qt::Edges(QFlag(static_cast<int>(record.autoHideTaskbarEdges)));
+    clock->now = record.timestamp;
+}
+
+QList<MessageTraceStatistics> MessageReplayer::replay(MessageTraceReader *reader)
+{
+    Q_ASSERT(reader);
+    if (!reader || !reader->isValid()) {
+        return {};
+    }
+    FakeWindowState window = {};
+    FakeClockState clock = {};
+    // The timestamps of the trace are in nanoseconds.
+    clock.frequency = 1000000000;
+    clock.vblankAvailable = false;
+    FakeWindowApi api(&window);
+    FakeWindowHost host(&window);
+    ShellStateCache shellStateCache(new FakeShellStateProvider(&window));
+    FramePacer framePacer(new FakeClock(&clock));
+    // Pacing would measure the replay clock instead of the handling.
+    framePacer.setMode(FramePacingMode::Off);
+    CaptionUpdateCoalescer captionUpdateCoalescer(new FakeClock(&clock));
+    NativeMessageHandler handler(&api, &shellStateCache, &framePacer, &captionUpdateCoalescer);
+    QMap<quint32, MessageTraceStatistics> statistics = {};
+    MessageTraceRecord record = {};
+    while (reader->read(&record)) {
+        applyRecord(record, &window, &clock);
+        // Each record carries its own shell state.
+        shellStateCache.invalidate();
+        NativeMessage message = {};
+        message.window = static_cast<quintptr>(record.window);
+        message.message = record.message;
+        message.wParam = record.wParam;
+        message.lParam = record.lParam;
+        NativeRect clientRect = record.proposedRect;
+        if (record.message == NativeMessageId::kNcCalcSize) {
+            message.clientRect = &clientRect;
+        }
+        quint32 windowPosFlags = record.proposedWindowPosFlags;
+        if (record.message == NativeMessageId::kWindowPosChanging) {
+            message.windowPosFlags = &windowPosFlags;
+        }
+        qint64 result = 0;
+        QElapsedTimer timer = {};
+        timer.start();
+        const bool handled = handler.handleMessage(&host, message, &result);
+        const qint64 duration = timer.nsecsElapsed();
+        static_cast<void>(captionUpdateCoalescer.takeDueWindows());
+        const bool mismatch = ((handled != record.handled) || (handled && (result != record.result))
+                               || (message.clientRect && (clientRect != record.adjustedRect))
+                               || (message.windowPosFlags && (windowPosFlags != record.adjustedWindowPosFlags)));
+        MessageTraceStatistics &entry = statistics[record.message];
+        entry.message = record.message;
+        ++entry.count;
+        if (handled) {
+            ++entry.handledCount;
+        }
+        entry.totalDuration += duration;
+        entry.maximumDuration = qMax(entry.maximumDuration, duration);
+        if (mismatch) {
+            ++entry.mismatchCount;
+        }
+    }
+    return statistics.values();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,51 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelesswindowsmanager.h"
+#ifdef FRAMELESSHELPER_PROBE_ALL_MODULES
+#include "framelesshelperwidgets.h"
+#include "framelessquickhelper.h"
+#endif
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// Started by tst_startup and exits right away, so only the work of the dynamic
+// loader is measured. The symbols are referenced to keep the libraries from
+// being dropped by linkers which only link what is used.
+int main()
+{
+    const void * const volatile symbols[] = {
+        reinterpret_cast<const void *>(&FramelessWindowsManager::addWindow),
+#ifdef FRAMELESSHELPER_PROBE_ALL_MODULES
+        reinterpret_cast<const void *>(&FramelessHelperWidgets::initialize),
+        &FramelessQuickHelper::staticMetaObject,
+#endif
+    };
+    for (auto &&symbol : symbols) {
+        if (!symbol) {
+            return 1;
+        }
+    }
+    return 0;
+}
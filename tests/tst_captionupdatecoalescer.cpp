@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qhash.h>
+#include "framelesscaptionupdatecoalescer.h"
+#include "framelessframepacer.h"
+#include "fakes.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_CaptionUpdateCoalescer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void firstUpdateIsImmediate()
+    {
+        FakeClockState clock = {};
+        clock.now = 100;
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        QCOMPARE(coalescer.nextDelay(), -1);
+        QCOMPARE(coalescer.schedule(1), 0);
+        QVERIFY(coalescer.isPending(1));
+        QCOMPARE(coalescer.schedule(1), -1);
+        QCOMPARE(coalescer.schedule(1), -1);
+        QCOMPARE(coalescer.nextDelay(), 0);
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        QVERIFY(!coalescer.isPending(1));
+        QCOMPARE(coalescer.requestedUpdates(), quint64(3));
+        QCOMPARE(coalescer.performedUpdates(), quint64(1));
+    }
+
+    void throttledToOnePerFrame()
+    {
+        FakeClockState clock = {};
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        QCOMPARE(coalescer.schedule(1), 0);
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        clock.now = 2;
+        QCOMPARE(coalescer.schedule(1), 14);
+        QCOMPARE(coalescer.schedule(1), -1);
+        QCOMPARE(coalescer.nextDelay(), 14);
+        clock.now = 15;
+        QVERIFY(coalescer.takeDueWindows().isEmpty());
+        QVERIFY(coalescer.isPending(1));
+        clock.now = 16;
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        QCOMPARE(coalescer.performedUpdates(), quint64(2));
+    }
+
+    // A title changing every millisecond, in several windows at once.
+    void severalWindows()
+    {
+        FakeClockState clock = {};
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        const QList<quintptr> windows = {1, 2, 3};
+        QHash<quintptr, QList<qint64>> updates = {};
+        for (clock.now = 0; clock.now != 160; ++clock.now) {
+            for (auto &&window : qAsConst(windows)) {
+                static_cast<void>(coalescer.schedule(window));
+            }
+            const QList<quintptr> due = coalescer.takeDueWindows();
+            for (auto &&window : qAsConst(due)) {
+                updates[window].append(clock.now);
+            }
+        }
+        QCOMPARE(coalescer.requestedUpdates(), quint64(160 * windows.size()));
+        for (auto &&window : qAsConst(windows)) {
+            const QList<qint64> times = updates.value(window);
+            // At most one update per frame, and no frame without one.
+            QCOMPARE(times.size(), 10);
+            for (int i = 1; i < times.size(); ++i) {
+                QCOMPARE(times.at(i) - times.at(i - 1), qint64(16));
+            }
+        }
+        QCOMPARE(coalescer.performedUpdates(), quint64(30));
+    }
+
+    void removeWindowWhilePending()
+    {
+        FakeClockState clock = {};
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        QCOMPARE(coalescer.schedule(1), 0);
+        QCOMPARE(coalescer.schedule(2), 0);
+        const QList<quintptr> due = coalescer.takeDueWindows();
+        QCOMPARE(due.size(), 2);
+        clock.now = 4;
+        QCOMPARE(coalescer.schedule(1), 12);
+        QCOMPARE(coalescer.schedule(2), 12);
+        coalescer.removeWindow(1);
+        QVERIFY(!coalescer.isPending(1));
+        QVERIFY(coalescer.isPending(2));
+        clock.now = 16;
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{2});
+        QCOMPARE(coalescer.nextDelay(), -1);
+        // A removed window starts over, without any throttling.
+        QCOMPARE(coalescer.schedule(1), 0);
+        coalescer.removeWindow(1);
+        QCOMPARE(coalescer.nextDelay(), -1);
+        QVERIFY(coalescer.takeDueWindows().isEmpty());
+        QCOMPARE(coalescer.performedUpdates(), quint64(3));
+    }
+
+    void idleWindowIsForgotten()
+    {
+        FakeClockState clock = {};
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        QCOMPARE(coalescer.schedule(1), 0);
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        clock.now = 40;
+        QVERIFY(coalescer.takeDueWindows().isEmpty());
+        QCOMPARE(coalescer.schedule(1), 0);
+    }
+
+    // The refresh rate is only asked for again after a display change.
+    void frameIntervalIsCached()
+    {
+        FakeClockState clock = {};
+        CaptionUpdateCoalescer coalescer(new FakeClock(&clock));
+        QCOMPARE(coalescer.schedule(1), 0);
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        clock.period = 32;
+        clock.now = 2;
+        QCOMPARE(coalescer.schedule(1), 14);
+        clock.now = 16;
+        QCOMPARE(coalescer.takeDueWindows(), QList<quintptr>{1});
+        coalescer.invalidateFrameInterval();
+        clock.now = 18;
+        QCOMPARE(coalescer.schedule(1), 30);
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_CaptionUpdateCoalescer)
+
+#include "tst_captionupdatecoalescer.moc"
@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include "framelessframegeometry.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class FakeShellStateProvider : public ShellStateProvider
+{
+public:
+    explicit FakeShellStateProvider(bool *autoHide, Qt::Edges *edges, int *queries)
+        : m_autoHide(autoHide), m_edges(edges), m_queries(queries) {}
+    ~FakeShellStateProvider() override = default;
+
+    [[nodiscard]] bool isTaskbarAutoHide() const override
+    {
+        ++(*m_queries);
+        return *m_autoHide;
+    }
+
+    [[nodiscard]] Qt::Edges getAutoHideTaskbarEdges(const quintptr monitor) const override
+    {
+        Q_UNUSED(monitor);
+        ++(*m_queries);
+        return *m_edges;
+    }
+
+private:
+    bool *m_autoHide = nullptr;
+    Qt::Edges *m_edges = nullptr;
+    int *m_queries = nullptr;
+};
+
+class tst_FrameGeometry : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void clientMargins_data();
+    void clientMargins();
+    void shellStateCache();
+    void shellStateCachePerMonitor();
+};
+
+void tst_FrameGeometry::clientMargins_data()
+{
+    QTest::addColumn<bool>("maximized");
+    QTest::addColumn<bool>("fullScreen");
+    QTest::addColumn<int>("autoHideTaskbarEdges");
+    QTest::addColumn<QMargins>("expected");
+
+    QTest::newRow("normal") << false << false << 0 << QMargins();
+    QTest::newRow("normal, auto-hide taskbar") << false << false << int(Qt::BottomEdge) << QMargins();
+    QTest::newRow("maximized") << true << false << 0 << QMargins(8, 8, 8, 8);
+    QTest::newRow("full screen") << false << true << 0 << QMargins();
+    QTest::newRow("maximized full screen") << true << true << 0 << QMargins();
+    QTest::newRow("maximized, top") << true << false << int(Qt::TopEdge) << QMargins(8, 10, 8, 8);
+    QTest::newRow("maximized, bottom") << true << false << int(Qt::BottomEdge) << QMargins(8, 8, 8, 10);
+    QTest::newRow("maximized, left") << true << false << int(Qt::LeftEdge) << QMargins(10, 8, 8, 8);
+    QTest::newRow("maximized, right") << true << false << int(Qt::RightEdge) << QMargins(8, 8, 10, 8);
+    QTest::newRow("full screen, top") << false << true << int(Qt::TopEdge) << QMargins(0, 2, 0, 0);
+    QTest::newRow("full screen, bottom") << false << true << int(Qt::BottomEdge) << QMargins(0, 0, 0, 2);
+    QTest::newRow("full screen, left") << false << true << int(Qt::LeftEdge) << QMargins(2, 0, 0, 0);
+    QTest::newRow("full screen, right") << false << true << int(Qt::RightEdge) << QMargins(0, 0, 2, 0);
+    // Only one edge is taken into account, just like what the system does.
+    QTest::newRow("maximized, top and left") << true << false << int(Qt::TopEdge | Qt::LeftEdge) << QMargins(8, 10, 8, 8);
+}
+
+void tst_FrameGeometry::clientMargins()
+{
+    QFETCH(bool, maximized);
+    QFETCH(bool, fullScreen);
+    QFETCH(int, autoHideTaskbarEdges);
+    QFETCH(QMargins, expected);
+
+    FrameGeometryState state = {};
+    state.maximized = maximized;
+    state.fullScreen = fullScreen;
+    state.resizeBorderThickness = 8;
+    state.autoHideTaskbarEdges = Qt::Edges(autoHideTaskbarEdges);
+    state.autoHideTaskbarThickness = 2;
+    QCOMPARE(FrameGeometry::calculateClientMargins(state), expected);
+}
+
+void tst_FrameGeometry::shellStateCache()
+{
+    bool autoHide = true;
+    Qt::Edges edges = Qt::BottomEdge;
+    int queries = 0;
+    ShellStateCache cache(new FakeShellStateProvider(&autoHide, &edges, &queries));
+
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges(Qt::BottomEdge));
+    QCOMPARE(queries, 2);
+    // Answered from the cache, even if the shell state has changed meanwhile.
+    edges = Qt::TopEdge;
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges(Qt::BottomEdge));
+    QCOMPARE(queries, 2);
+
+    cache.invalidate();
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges(Qt::TopEdge));
+    QCOMPARE(queries, 4);
+
+    // The edges are not queried at all without an auto-hide taskbar.
+    autoHide = false;
+    cache.invalidate();
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges());
+    QCOMPARE(queries, 5);
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges());
+    QCOMPARE(queries, 5);
+}
+
+void tst_FrameGeometry::shellStateCachePerMonitor()
+{
+    bool autoHide = true;
+    Qt::Edges edges = Qt::LeftEdge;
+    int queries = 0;
+    ShellStateCache cache(new FakeShellStateProvider(&autoHide, &edges, &queries));
+
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges(Qt::LeftEdge));
+    QCOMPARE(queries, 2);
+    // Each monitor is asked once.
+    edges = Qt::RightEdge;
+    QCOMPARE(cache.getAutoHideTaskbarEdges(2), Qt::Edges(Qt::RightEdge));
+    QCOMPARE(queries, 3);
+    QCOMPARE(cache.getAutoHideTaskbarEdges(1), Qt::Edges(Qt::LeftEdge));
+    QCOMPARE(cache.getAutoHideTaskbarEdges(2), Qt::Edges(Qt::RightEdge));
+    QCOMPARE(queries, 3);
+}
+
+QTEST_APPLESS_MAIN(tst_FrameGeometry)
+
+#include "tst_framegeometry.moc"
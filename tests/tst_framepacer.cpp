@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include "framelessframepacer.h"
+#include "fakes.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_FramePacer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void ticksUntilNextVBlank_data()
+    {
+        QTest::addColumn<qint64>("now");
+        QTest::addColumn<qint64>("vblank");
+        QTest::addColumn<qint64>("period");
+        QTest::addColumn<qint64>("expected");
+        QTest::newRow("future") << qint64(100) << qint64(130) << qint64(50) << qint64(30);
+        QTest::newRow("far future") << qint64(100) << qint64(1030) << qint64(50) << qint64(30);
+        QTest::newRow("past") << qint64(100) << qint64(80) << qint64(50) << qint64(30);
+        QTest::newRow("far past") << qint64(1000) << qint64(30) << qint64(50) << qint64(30);
+        QTest::newRow("now") << qint64(100) << qint64(100) << qint64(50) << qint64(0);
+        QTest::newRow("one period ago") << qint64(100) << qint64(50) << qint64(50) << qint64(0);
+        QTest::newRow("negative") << qint64(-10) << qint64(-45) << qint64(50) << qint64(15);
+        QTest::newRow("zero period") << qint64(100) << qint64(130) << qint64(0) << qint64(0);
+        QTest::newRow("negative period") << qint64(100) << qint64(130) << qint64(-50) << qint64(0);
+    }
+
+    void ticksUntilNextVBlank()
+    {
+        QFETCH(qint64, now);
+        QFETCH(qint64, vblank);
+        QFETCH(qint64, period);
+        QFETCH(qint64, expected);
+        QCOMPARE(FramePacer::ticksUntilNextVBlank(now, vblank, period), expected);
+    }
+
+    void off()
+    {
+        FakeClockState state = {};
+        FramePacer pacer(new FakeClock(&state));
+        pacer.setMode(FramePacingMode::Off);
+        QCOMPARE(pacer.pace(1), -1);
+        QCOMPARE(state.queries, 0);
+        QCOMPARE(state.slept, qint64(0));
+        QCOMPARE(pacer.pacedFrames(), quint64(0));
+        QCOMPARE(pacer.blockedTime(), qint64(0));
+    }
+
+    void sleepToVBlank()
+    {
+        FakeClockState state = {};
+        state.now = 100;
+        state.vblank = 48;
+        FramePacer pacer(new FakeClock(&state));
+        QCOMPARE(pacer.mode(), FramePacingMode::SleepToVBlank);
+        QCOMPARE(pacer.pace(1), -1);
+        // The vertical blanks are at 100 + 12 + n * 16.
+        QCOMPARE(state.slept, qint64(12));
+        QCOMPARE(state.now, qint64(112));
+        QCOMPARE(pacer.pacedFrames(), quint64(1));
+        QCOMPARE(pacer.blockedTime(), qint64(12000000));
+        // Right on a vertical blank, nothing to wait for.
+        QCOMPARE(pacer.pace(1), -1);
+        QCOMPARE(state.slept, qint64(12));
+        QCOMPARE(pacer.pacedFrames(), quint64(2));
+        QCOMPARE(pacer.blockedTime(), qint64(12000000));
+        state.now += 4;
+        QCOMPARE(pacer.pace(2), -1);
+        QCOMPARE(state.slept, qint64(24));
+        QCOMPARE(pacer.pacedFrames(), quint64(3));
+        QCOMPARE(pacer.blockedTime(), qint64(24000000));
+        QVERIFY(!pacer.isDeferredUpdatePending(1));
+    }
+
+    void deferred()
+    {
+        FakeClockState state = {};
+        state.now = 100;
+        state.vblank = 48;
+        FramePacer pacer(new FakeClock(&state));
+        pacer.setMode(FramePacingMode::Deferred);
+        QCOMPARE(pacer.pace(1), 12);
+        QVERIFY(pacer.isDeferredUpdatePending(1));
+        QCOMPARE(state.slept, qint64(0));
+        QCOMPARE(pacer.blockedTime(), qint64(0));
+        QCOMPARE(pacer.pacedFrames(), quint64(1));
+        // More resize steps before the vertical blank: the pending update covers them.
+        state.now += 5;
+        QCOMPARE(pacer.pace(1), -1);
+        QCOMPARE(pacer.pace(1), -1);
+        QCOMPARE(pacer.pacedFrames(), quint64(1));
+        // Other windows have their own update.
+        QCOMPARE(pacer.pace(2), 7);
+        QVERIFY(pacer.isDeferredUpdatePending(2));
+        QCOMPARE(pacer.pacedFrames(), quint64(2));
+        state.now += 7;
+        pacer.deferredUpdateDone(1);
+        QVERIFY(!pacer.isDeferredUpdatePending(1));
+        QVERIFY(pacer.isDeferredUpdatePending(2));
+        state.now += 1;
+        QCOMPARE(pacer.pace(1), 15);
+        pacer.removeWindow(2);
+        QVERIFY(!pacer.isDeferredUpdatePending(2));
+        QCOMPARE(pacer.pace(2), 15);
+        QCOMPARE(pacer.blockedTime(), qint64(0));
+        QCOMPARE(state.slept, qint64(0));
+    }
+
+    void deferredUpdateLost()
+    {
+        FakeClockState state = {};
+        state.period = 20;
+        FramePacer pacer(new FakeClock(&state));
+        pacer.setMode(FramePacingMode::Deferred);
+        QCOMPARE(pacer.pace(1), 0);
+        state.now += 999;
+        QCOMPARE(pacer.pace(1), -1);
+        // Overdue by a second: the window must have gone away without reporting back.
+        state.now += 1;
+        QCOMPARE(pacer.pace(1), 0);
+    }
+
+    void noVBlank()
+    {
+        FakeClockState state = {};
+        state.vblankAvailable = false;
+        FramePacer pacer(new FakeClock(&state));
+        QCOMPARE(pacer.pace(1), -1);
+        pacer.setMode(FramePacingMode::Deferred);
+        QCOMPARE(pacer.pace(1), -1);
+        QVERIFY(!pacer.isDeferredUpdatePending(1));
+        QCOMPARE(state.slept, qint64(0));
+        QCOMPARE(pacer.pacedFrames(), quint64(0));
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_FramePacer)
+
+#include "tst_framepacer.moc"
@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qwindow.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qcursor.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qthread.h>
+#include "framelesswindowsmanager.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// One second of motion from a mouse polling at 8 kHz.
+static constexpr int kMotionEventsPerSecond = 8000;
+// The stream is paced in real time: the event loop runs once per millisecond of
+// motion, after the millisecond has passed, so that the per frame evaluation of
+// the coalesced motion happens as often as it does with a real mouse.
+static constexpr int kMotionEventsPerMillisecond = (kMotionEventsPerSecond / 1000);
+
+[[nodiscard]] static inline int getRefreshInterval(const QWindow *window)
+{
+    const QScreen *screen = window->screen();
+    const qreal refreshRate = (screen ? screen->refreshRate() : 0.0);
+    return qMax(1, qRound(1000.0 / ((refreshRate > 0.0) ? refreshRate : 60.0)));
+}
+
+class tst_InputCoalescing : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void motion_data();
+    void motion();
+};
+
+void tst_InputCoalescing::motion_data()
+{
+    QTest::addColumn<bool>("coalescing");
+    QTest::newRow("immediate") << false;
+    QTest::newRow("coalesced") << true;
+}
+
+// Reports the time spent on one second of motion, with and without coalescing,
+// and checks that both end with the cursor shape of the last position.
+void tst_InputCoalescing::motion()
+{
+#ifndef FRAMELESSHELPER_USE_UNIX_VERSION
+    QSKIP("The motion is handled by the native event filter on this platform.");
+#else
+    QFETCH(bool, coalescing);
+    QWindow window;
+    window.resize(400, 300);
+    FramelessWindowsManager::addWindow(&window);
+    FramelessWindowsManager::setInputCoalescing(&window, coalescing);
+    const int resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(&window);
+    const int motionWidth = (resizeBorderThickness * 2 + 2);
+    // Only the time spent in the event handling is reported, not the pacing.
+    QElapsedTimer timer = {};
+    qint64 elapsed = 0;
+    for (int i = 0; i != kMotionEventsPerSecond; ++i) {
+        // Back and forth across the left edge, so the cursor shape changes.
+        const QPointF pos = {static_cast<qreal>(i % motionWidth), 150.0};
+        QMouseEvent event(QEvent::MouseMove, pos, window.mapToGlobal(pos.toPoint()),
+                          Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        timer.start();
+        QCoreApplication::sendEvent(&window, &event);
+        elapsed += timer.nsecsElapsed();
+        if (((i + 1) % kMotionEventsPerMillisecond) == 0) {
+            QThread::msleep(1);
+            timer.start();
+            QCoreApplication::processEvents();
+            elapsed += timer.nsecsElapsed();
+        }
+    }
+    QTest::setBenchmarkResult(static_cast<qreal>(elapsed) / 1000000.0, QTest::WalltimeMilliseconds);
+    // Let the last frame end, so that the latest coalesced position is evaluated.
+    QTest::qWait(getRefreshInterval(&window) * 2);
+    const int lastX = ((kMotionEventsPerSecond - 1) % motionWidth);
+    const Qt::CursorShape expectedShape = ((lastX <= resizeBorderThickness) ? Qt::SizeHorCursor : Qt::ArrowCursor);
+    const Qt::CursorShape shape = window.cursor().shape();
+    FramelessWindowsManager::removeWindow(&window);
+    QCOMPARE(shape, expectedShape);
+#endif
+}
+
+QTEST_MAIN(tst_InputCoalescing)
+
+#include "tst_inputcoalescing.moc"
@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include "framelessmessagehandler.h"
+#include "framelessframegeometry.h"
+#include "framelessframepacer.h"
+#include "framelesscaptionupdatecoalescer.h"
+#include "fakes.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr quint32 kTimerMessage = 0x0113; // WM_TIMER
+static constexpr quint32 kPaintMessage = 0x000F; // WM_PAINT
+static constexpr quint32 kMouseMoveMessage = 0x0200; // WM_MOUSEMOVE
+static constexpr quint32 kUserMessage = 0x0400; // WM_USER
+
+class tst_MessageHandler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void caseLabelsAreHandled_data()
+    {
+        QTest::addColumn<quint32>("message");
+        QTest::newRow("WM_SETTINGCHANGE") << NativeMessageId::kSettingChange;
+        QTest::newRow("WM_DISPLAYCHANGE") << NativeMessageId::kDisplayChange;
+        QTest::newRow("WM_NCCALCSIZE") << NativeMessageId::kNcCalcSize;
+        QTest::newRow("WM_NCUAHDRAWCAPTION") << NativeMessageId::kNcUahDrawCaption;
+        QTest::newRow("WM_NCUAHDRAWFRAME") << NativeMessageId::kNcUahDrawFrame;
+        QTest::newRow("WM_NCPAINT") << NativeMessageId::kNcPaint;
+        QTest::newRow("WM_NCACTIVATE") << NativeMessageId::kNcActivate;
+        QTest::newRow("WM_NCHITTEST") << NativeMessageId::kNcHitTest;
+        QTest::newRow("WM_SETICON") << NativeMessageId::kSetIcon;
+        QTest::newRow("WM_SETTEXT") << NativeMessageId::kSetText;
+#if (QT_VERSION < QT_VERSION_CHECK(6, 2, 2))
+        QTest::newRow("WM_WINDOWPOSCHANGING") << NativeMessageId::kWindowPosChanging;
+#endif
+    }
+
+    void caseLabelsAreHandled()
+    {
+        QFETCH(quint32, message);
+        QVERIFY(NativeMessageHandler::isHandledMessage(message));
+    }
+
+    void otherMessagesAreRejected_data()
+    {
+        QTest::addColumn<quint32>("message");
+        QTest::newRow("WM_NULL") << quint32(0);
+        QTest::newRow("WM_TIMER") << kTimerMessage;
+        QTest::newRow("WM_PAINT") << kPaintMessage;
+        QTest::newRow("WM_MOUSEMOVE") << kMouseMoveMessage;
+        QTest::newRow("WM_USER") << kUserMessage;
+        QTest::newRow("WM_USER + 0x83") << (kUserMessage + NativeMessageId::kNcCalcSize);
+        QTest::newRow("WM_APP") << quint32(0x8000);
+        QTest::newRow("registered") << quint32(0xC000);
+        QTest::newRow("maximum") << quint32(0xFFFFFFFF);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 2))
+        // Qt takes care of it itself since 6.2.2.
+        QTest::newRow("WM_WINDOWPOSCHANGING") << NativeMessageId::kWindowPosChanging;
+#endif
+    }
+
+    void otherMessagesAreRejected()
+    {
+        QFETCH(quint32, message);
+        QVERIFY(!NativeMessageHandler::isHandledMessage(message));
+    }
+
+    // Feeds every message ID below 0x1000 through the handler: exactly the ones
+    // the native event filter lets through may do anything, the switch and the
+    // set can't get out of sync without this test noticing.
+    void syntheticMessageStream()
+    {
+        FakeWindowState window = {};
+        FakeClockState clock = {};
+        clock.vblankAvailable = false;
+        FakeWindowApi api(&window);
+        FakeWindowHost host(&window);
+        ShellStateCache shellStateCache(new FakeShellStateProvider(&window));
+        FramePacer framePacer(new FakeClock(&clock));
+        framePacer.setMode(FramePacingMode::Off);
+        CaptionUpdateCoalescer captionUpdateCoalescer(new FakeClock(&clock));
+        NativeMessageHandler handler(&api, &shellStateCache, &framePacer, &captionUpdateCoalescer);
+        QList<quint32> reacted = {};
+        for (quint32 id = 0; id != 0x1000; ++id) {
+            // Fill the shell state cache, so that an invalidation shows up as a new query.
+            static_cast<void>(shellStateCache.getAutoHideTaskbarEdges(1));
+            // Every message starts from the same window, with the counters reset.
+            window = {};
+            NativeRect clientRect = {0, 0, 800, 600};
+            quint32 windowPosFlags = 0;
+            NativeMessage message = {};
+            message.window = 0x1234;
+            message.message = id;
+            message.lParam = ((100 << 16) | 100);
+            message.clientRect = &clientRect;
+            message.windowPosFlags = &windowPosFlags;
+            qint64 result = 0;
+            const bool handled = handler.handleMessage(&host, message, &result);
+            static_cast<void>(shellStateCache.getAutoHideTaskbarEdges(1));
+            const bool touched = (handled || (window.calls != 0) || (window.shellStateQueries != 0) || (windowPosFlags != 0));
+            if (touched) {
+                reacted.append(id);
+            }
+            QVERIFY2(touched == NativeMessageHandler::isHandledMessage(id),
+                     qPrintable(QStringLiteral("Message 0x%1").arg(id, 4, 16, QLatin1Char('0'))));
+            if (!handled) {
+                QCOMPARE(result, qint64(0));
+            }
+            static_cast<void>(captionUpdateCoalescer.takeDueWindows());
+        }
+        QVERIFY(!reacted.contains(kTimerMessage));
+        QVERIFY(!reacted.contains(kPaintMessage));
+        QVERIFY(!reacted.contains(kMouseMoveMessage));
+        for (auto &&id : qAsConst(reacted)) {
+            QVERIFY(id < kUserMessage);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_MessageHandler)
+
+#include "tst_messagehandler.moc"
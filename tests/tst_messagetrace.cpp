@@ -0,0 +1,230 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qbuffer.h>
+#include "framelessmessagetrace.h"
+#include "framelessframegeometry.h"
+#include "fakes.h"
+#include "messagereplayer.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+[[nodiscard]] static inline qint64 makePointLParam(const int x, const int y)
+{
+    return ((static_cast<qint64>(y & 0xFFFF) << 16) | static_cast<qint64>(x & 0xFFFF));
+}
+
+[[nodiscard]] static inline MessageTraceRecord makeRestoredRecord(const quint32 message)
+{
+    MessageTraceRecord record = {};
+    record.window = 0x1234;
+    record.message = message;
+    record.windowState = Qt::WindowNoState;
+    record.dwmComposition = true;
+    record.clientX = 100;
+    record.clientY = 100;
+    record.clientWidth = 800;
+    record.clientHeight = 600;
+    record.resizeBorderThickness = 8;
+    record.titleBarHeight = 30;
+    return record;
+}
+
+[[nodiscard]] static inline QByteArray writeTrace(const QList<MessageTraceRecord> &records)
+{
+    QByteArray data = {};
+    QBuffer buffer(&data);
+    buffer.open(QBuffer::WriteOnly);
+    MessageTraceWriter writer(&buffer);
+    for (auto &&record : qAsConst(records)) {
+        writer.write(record);
+    }
+    return data;
+}
+
+class tst_MessageTrace : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void roundTrip()
+    {
+        MessageTraceRecord calcSize = makeRestoredRecord(NativeMessageId::kNcCalcSize);
+        calcSize.timestamp = 42;
+        calcSize.wParam = 1;
+        calcSize.lParam = -1;
+        calcSize.handled = true;
+        calcSize.duration = 1500;
+        calcSize.maximized = true;
+        calcSize.hitTestVisible = true;
+        calcSize.autoHideTaskbarEdges = Qt::BottomEdge;
+        calcSize.proposedRect = {-8, -8, 1928, 1088};
+        calcSize.adjustedRect = {0, 0, 1920, 1078};
+        MessageTraceRecord setText = makeRestoredRecord(NativeMessageId::kSetText);
+        setText.handled = true;
+        setText.result = 1;
+        setText.text = (QStringLiteral("Frameless ") + QChar(0x00E9) + QChar(0x4F60));
+        const QByteArray data = writeTrace({calcSize, setText});
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QBuffer::ReadOnly);
+        MessageTraceReader reader(&buffer);
+        QVERIFY(reader.isValid());
+        MessageTraceRecord record = {};
+        QVERIFY(reader.read(&record));
+        QCOMPARE(record.timestamp, calcSize.timestamp);
+        QCOMPARE(record.message, calcSize.message);
+        QCOMPARE(record.lParam, calcSize.lParam);
+        QCOMPARE(record.duration, calcSize.duration);
+        QVERIFY(record.handled);
+        QVERIFY(record.maximized);
+        QVERIFY(record.hitTestVisible);
+        QVERIFY(record.dwmComposition);
+        QVERIFY(!record.fixedSize);
+        QVERIFY(!record.ownHitTest);
+        QCOMPARE(record.clientX, 100);
+        QCOMPARE(record.clientHeight, 600);
+        QCOMPARE(record.titleBarHeight, 30);
+        QCOMPARE(record.autoHideTaskbarEdges, quint32(Qt::BottomEdge));
+        QCOMPARE(record.proposedRect.right, 1928);
+        QCOMPARE(record.adjustedRect.bottom, 1078);
+        QVERIFY(record.text.isEmpty());
+        QVERIFY(reader.read(&record));
+        QCOMPARE(record.message, NativeMessageId::kSetText);
+        QCOMPARE(record.text, setText.text);
+        QVERIFY(!reader.read(&record));
+    }
+
+    void rejectsOtherVersions()
+    {
+        QByteArray data = writeTrace({});
+        QCOMPARE(data.size(), 8);
+        data[4] = 1;
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QBuffer::ReadOnly);
+        MessageTraceReader reader(&buffer);
+        QVERIFY(!reader.isValid());
+    }
+
+    void captureEnvironment()
+    {
+        // Maximized: the client area covers the monitor, the frame is outside of it.
+        FakeWindowState window = {};
+        window.maximized = true;
+        window.clientX = -8;
+        window.clientY = -8;
+        window.clientWidth = 1920;
+        window.clientHeight = 1080;
+        window.windowState = Qt::WindowMaximized;
+        window.titleBarHeight = 31;
+        window.hitTestVisible = true;
+        FakeWindowApi api(&window);
+        FakeWindowHost host(&window);
+        ShellStateCache shellStateCache(new FakeShellStateProvider(&window));
+        NativeRect clientRect = {-8, -8, 1928, 1088};
+        NativeMessage message = {};
+        message.window = 0x1234;
+        message.message = NativeMessageId::kNcCalcSize;
+        message.wParam = 1;
+        message.clientRect = &clientRect;
+        MessageTraceRecord record = {};
+        MessageTrace::captureEnvironment(&api, &host, &shellStateCache, message, &record);
+        QCOMPARE(record.window, quint64(0x1234));
+        QCOMPARE(record.message, NativeMessageId::kNcCalcSize);
+        QCOMPARE(record.windowState, quint32(Qt::WindowMaximized));
+        QVERIFY(record.maximized);
+        QVERIFY(record.hitTestVisible);
+        QVERIFY(record.dwmComposition);
+        QCOMPARE(record.clientX, -8);
+        QCOMPARE(record.clientY, -8);
+        QCOMPARE(record.clientWidth, 1920);
+        QCOMPARE(record.clientHeight, 1080);
+        QCOMPARE(record.resizeBorderThickness, 8);
+        QCOMPARE(record.titleBarHeight, 31);
+        QCOMPARE(record.autoHideTaskbarEdges, quint32(Qt::BottomEdge));
+        QCOMPARE(record.proposedRect.left, -8);
+        QCOMPARE(record.proposedRect.bottom, 1088);
+    }
+
+    void replay()
+    {
+        // Maximized: the resize borders are outside of the monitor.
+        MessageTraceRecord calcSize = makeRestoredRecord(NativeMessageId::kNcCalcSize);
+        calcSize.windowState = Qt::WindowMaximized;
+        calcSize.maximized = true;
+        calcSize.wParam = 1;
+        calcSize.handled = true;
+        calcSize.proposedRect = {-8, -8, 1928, 1088};
+        calcSize.adjustedRect = {0, 0, 1920, 1080};
+        // Restored: in the title bar, below the top resize border.
+        MessageTraceRecord caption = makeRestoredRecord(NativeMessageId::kNcHitTest);
+        caption.timestamp = 1000000;
+        caption.lParam = makePointLParam(500, 115);
+        caption.handled = true;
+        caption.result = NativeHitTestResult::kCaption;
+        // Recorded with a different answer than the handling gives now.
+        MessageTraceRecord changed = caption;
+        changed.timestamp = 2000000;
+        changed.result = NativeHitTestResult::kClient;
+        // Windows which do their own hit-testing are left alone.
+        MessageTraceRecord ownHitTest = caption;
+        ownHitTest.timestamp = 3000000;
+        ownHitTest.ownHitTest = true;
+        ownHitTest.handled = false;
+        ownHitTest.result = 0;
+        MessageTraceRecord setText = makeRestoredRecord(NativeMessageId::kSetText);
+        setText.timestamp = 4000000;
+        setText.handled = true;
+        setText.result = 1;
+        setText.text = QStringLiteral("Title");
+        const QByteArray data = writeTrace({calcSize, caption, changed, ownHitTest, setText});
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QBuffer::ReadOnly);
+        MessageTraceReader reader(&buffer);
+        QVERIFY(reader.isValid());
+        const QList<MessageTraceStatistics> statistics = MessageReplayer::replay(&reader);
+        QCOMPARE(statistics.size(), 3);
+        // Sorted by the message ID.
+        QCOMPARE(statistics.at(0).message, NativeMessageId::kSetText);
+        QCOMPARE(statistics.at(0).count, quint64(1));
+        QCOMPARE(statistics.at(0).handledCount, quint64(1));
+        QCOMPARE(statistics.at(0).mismatchCount, quint64(0));
+        QCOMPARE(statistics.at(1).message, NativeMessageId::kNcCalcSize);
+        QCOMPARE(statistics.at(1).count, quint64(1));
+        QCOMPARE(statistics.at(1).handledCount, quint64(1));
+        QCOMPARE(statistics.at(1).mismatchCount, quint64(0));
+        QCOMPARE(statistics.at(2).message, NativeMessageId::kNcHitTest);
+        QCOMPARE(statistics.at(2).count, quint64(3));
+        QCOMPARE(statistics.at(2).handledCount, quint64(2));
+        QCOMPARE(statistics.at(2).mismatchCount, quint64(1));
+        QVERIFY(statistics.at(2).totalDuration >= statistics.at(2).maximumDuration);
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_MessageTrace)
+
+#include "tst_messagetrace.moc"
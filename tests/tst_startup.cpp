@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qprocess.h>
+
+class tst_Startup : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void startup_data();
+    void startup();
+};
+
+void tst_Startup::startup_data()
+{
+    QTest::addColumn<QString>("probe");
+    // Only links FramelessHelperCore, what an application which doesn't use Qt
+    // Quick loads now that the library is split.
+    QTest::newRow("core") << QStringLiteral("startupprobe_core");
+    // Links every module, including Qt Quick and Qt QML, like every application
+    // did before the split.
+    QTest::newRow("all modules") << QStringLiteral("startupprobe_all");
+}
+
+// Reports the time from starting a process until it has exited, which is
+// dominated by loading and relocating the shared libraries it links.
+void tst_Startup::startup()
+{
+    QFETCH(QString, probe);
+    QString fileName = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath(probe);
+#ifdef Q_OS_WINDOWS
+    fileName += QStringLiteral(".exe");
+#endif
+    if (!QFileInfo::exists(fileName)) {
+        QSKIP("The probe has not been built, the module it needs is not available.");
+    }
+    QBENCHMARK {
+        QProcess process;
+        process.start(fileName, {});
+        QVERIFY(process.waitForFinished());
+        QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+        QCOMPARE(process.exitCode(), 0);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_Startup)
+
+#include "tst_startup.moc"
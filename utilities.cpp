@@ -25,10 +25,57 @@
 #include "utilities.h"
 #include <QtCore/qdebug.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmath.h>
 #include <QtGui/qguiapplication.h>
+#include "framelesswindowsmanager.h"
+#include "framelesshittesttable.h"
+#include "framelessstatistics.h"
+#include "framelesstracer.h"
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
+struct RoundedCorners
+{
+    QRegion topLeft = {};
+    QRegion topRight = {};
+    QRegion bottomLeft = {};
+    QRegion bottomRight = {};
+};
+
+// The mask of a window is in device independent pixels and Qt scales it to the
+// device pixel ratio of the window, so the corners only depend on the radius.
+using RoundedCornersCache = QHash<int, RoundedCorners>;
+
+Q_GLOBAL_STATIC(RoundedCornersCache, g_roundedCornersCache)
+
+static Utilities::SystemMenuProvider g_systemMenuProvider = nullptr;
+
+[[nodiscard]] static inline RoundedCorners createRoundedCorners(const int radius)
+{
+    Q_ASSERT(radius > 0);
+    // Each corner is a stack of one pixel high rows, all of them are placed inside a
+    // (radius x radius) square located at the origin. The arc is sampled at the
+    // center of each row.
+    RoundedCorners corners = {};
+    const qreal r = static_cast<qreal>(radius);
+    for (int row = 0; row != radius; ++row) {
+        const qreal dy = r - (static_cast<qreal>(row) + 0.5);
+        const qreal dx = qSqrt(qMax(0.0, (r * r) - (dy * dy)));
+        const int inset = qBound(0, qRound(r - dx), radius);
+        const int length = radius - inset;
+        if (length <= 0) {
+            continue;
+        }
+        const int mirroredRow = radius - row - 1;
+        corners.topLeft += QRect(inset, row, length, 1);
+        corners.topRight += QRect(0, row, length, 1);
+        corners.bottomLeft += QRect(inset, mirroredRow, length, 1);
+        corners.bottomRight += QRect(0, mirroredRow, length, 1);
+    }
+    return corners;
+}
+
 QWindow *Utilities::findWindow(const WId winId)
 {
     Q_ASSERT(winId);
@@ -74,11 +121,28 @@ bool Utilities::isHitTestVisible(const QWindow *window)
     if (!window) {
         return false;
     }
+    return isHitTestVisible(window, window->mapFromGlobal(QCursor::pos(window->screen())));
+}
+
+bool Utilities::isHitTestVisible(const QWindow *window, const QPointF &localPos)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    FRAMELESSHELPER_TRACE_SCOPE("isHitTestVisible");
+    // Computed once per frame by the owners of the items, in window coordinates.
+    if (HitTestTable::windowContains(window, localPos)) {
+        return true;
+    }
     const auto objs = qvariant_cast<QObjectList>(window->property(Constants::kHitTestVisibleFlag));
     if (objs.isEmpty()) {
         return false;
     }
+    // The origin points of the objects include the position of the window.
+    const QPointF globalPos = (localPos + QPointF(window->position()));
     for (auto &&obj : qAsConst(objs)) {
+        FRAMELESSHELPER_STATISTICS_INCREMENT(window, HitTestVisibleObjectsScanned);
         if (!obj || !(obj->isWidgetType() || obj->inherits("QQuickItem"))) {
             continue;
         }
@@ -86,16 +150,48 @@ bool Utilities::isHitTestVisible(const QWindow *window)
             continue;
         }
         const QPointF originPoint = mapOriginPointToWindow(obj);
+        // Objects may expose only some parts of themselves (in their own coordinate
+        // system), the rest of them is treated as the title bar.
+        const QVariant subRects = obj->property(Constants::kHitTestVisibleRectsFlag);
+        if (subRects.isValid()) {
+            const auto rects = qvariant_cast<QList<QRectF>>(subRects);
+            for (auto &&subRect : qAsConst(rects)) {
+                if (subRect.translated(originPoint).contains(globalPos)) {
+                    return true;
+                }
+            }
+            continue;
+        }
         const qreal width = obj->property("width").toReal();
         const qreal height = obj->property("height").toReal();
         const QRectF rect = {originPoint.x(), originPoint.y(), width, height};
-        if (rect.contains(QCursor::pos(window->screen()))) {
+        if (rect.contains(globalPos)) {
             return true;
         }
     }
     return false;
 }
 
+bool Utilities::isInsideTitleBar(const QWindow *window, const QPointF &pos, const int resizeBorderThickness)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    const int titleBarHeight = FramelessWindowsManager::getTitleBarHeight(window);
+    const int windowWidth = window->width();
+    const Qt::WindowState state = window->windowState();
+    if ((state == Qt::WindowMaximized) || (state == Qt::WindowFullScreen)) {
+        return (pos.y() >= 0) && (pos.y() <= titleBarHeight)
+                && (pos.x() >= 0) && (pos.x() <= windowWidth);
+    }
+    if (state == Qt::WindowNoState) {
+        return (pos.y() > resizeBorderThickness) && (pos.y() <= titleBarHeight)
+                && (pos.x() > resizeBorderThickness) && (pos.x() < (windowWidth - resizeBorderThickness));
+    }
+    return false;
+}
+
 QPointF Utilities::mapOriginPointToWindow(const QObject *object)
 {
     Q_ASSERT(object);
@@ -116,4 +212,44 @@ QPointF Utilities::mapOriginPointToWindow(const QObject *object)
     return point;
 }
 
+QRegion Utilities::getRoundedCornerMask(const QSize &size, const qreal radius)
+{
+    Q_ASSERT(size.isValid());
+    if (!size.isValid() || size.isEmpty()) {
+        return {};
+    }
+    const int width = size.width();
+    const int height = size.height();
+    const int r = qMin(qRound(radius), (qMin(width, height) / 2));
+    if (r <= 0) {
+        return QRegion(0, 0, width, height);
+    }
+    auto it = g_roundedCornersCache()->constFind(r);
+    if (it == g_roundedCornersCache()->constEnd()) {
+        it = g_roundedCornersCache()->insert(r, createRoundedCorners(r));
+    } else {
+        FRAMELESSHELPER_STATISTICS_INCREMENT(nullptr, MetricCacheHits);
+    }
+    const RoundedCorners &corners = it.value();
+    // Two overlapping rectangles cover everything except the four corner squares,
+    // the cached corner regions only need to be moved to their final position.
+    QRegion mask(r, 0, (width - (r * 2)), height);
+    mask += QRect(0, r, width, (height - (r * 2)));
+    mask += corners.topLeft;
+    mask += corners.topRight.translated((width - r), 0);
+    mask += corners.bottomLeft.translated(0, (height - r));
+    mask += corners.bottomRight.translated((width - r), (height - r));
+    return mask;
+}
+
+void Utilities::setSystemMenuProvider(const SystemMenuProvider provider)
+{
+    g_systemMenuProvider = provider;
+}
+
+Utilities::SystemMenuProvider Utilities::getSystemMenuProvider()
+{
+    return g_systemMenuProvider;
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -32,11 +32,20 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 namespace Utilities
 {
 
+// Used on platforms without a native system menu, takes the position in device
+// independent pixels, in the global coordinate system.
+using SystemMenuProvider = bool(*)(QWindow *window, const QPoint &pos);
+
 [[nodiscard]] FRAMELESSHELPER_API int getSystemMetric(const QWindow *window, const SystemMetric metric, const bool dpiScale, const bool forceSystemValue = false);
 [[nodiscard]] FRAMELESSHELPER_API QWindow *findWindow(const WId winId);
 [[nodiscard]] FRAMELESSHELPER_API bool isWindowFixedSize(const QWindow *window);
+// Checks the current cursor position, use the overload below when handling an
+// event which has a position of its own (touch, pen).
 [[nodiscard]] FRAMELESSHELPER_API bool isHitTestVisible(const QWindow *window);
+[[nodiscard]] FRAMELESSHELPER_API bool isHitTestVisible(const QWindow *window, const QPointF &localPos);
+[[nodiscard]] FRAMELESSHELPER_API bool isInsideTitleBar(const QWindow *window, const QPointF &pos, const int resizeBorderThickness);
 [[nodiscard]] FRAMELESSHELPER_API QPointF mapOriginPointToWindow(const QObject *object);
+[[nodiscard]] FRAMELESSHELPER_API QRegion getRoundedCornerMask(const QSize &size, const qreal radius);
 [[nodiscard]] FRAMELESSHELPER_API QColor getColorizationColor();
 [[nodiscard]] FRAMELESSHELPER_API int getWindowVisibleFrameBorderThickness(const WId winId);
 [[nodiscard]] FRAMELESSHELPER_API bool shouldAppsUseDarkMode();
@@ -44,6 +53,12 @@ namespace Utilities
 [[nodiscard]] FRAMELESSHELPER_API bool isThemeChanged(const void *data);
 [[nodiscard]] FRAMELESSHELPER_API bool isSystemMenuRequested(const void *data, QPointF *pos);
 [[nodiscard]] FRAMELESSHELPER_API bool showSystemMenu(const WId winId, const QPointF &pos);
+FRAMELESSHELPER_API void setSystemMenuProvider(const SystemMenuProvider provider);
+[[nodiscard]] FRAMELESSHELPER_API SystemMenuProvider getSystemMenuProvider();
+// Lets the user move or size the window with the keyboard, like the "Move" and
+// "Size" entries of the native system menu. No mouse button has to be held.
+[[nodiscard]] FRAMELESSHELPER_API bool isKeyboardMoveResizeSupported();
+[[nodiscard]] FRAMELESSHELPER_API bool startKeyboardMoveResize(const WId winId, const bool resize);
 
 #ifdef Q_OS_WINDOWS
 [[nodiscard]] FRAMELESSHELPER_API bool isWin8OrGreater();
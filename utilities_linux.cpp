@@ -24,13 +24,187 @@
 
 #include "utilities.h"
 
+#include <QtCore/qdebug.h>
 #include <QtCore/qvariant.h>
+#include <QtGui/qguiapplication.h>
+#include "framelesswindowsmanager.h"
+#ifdef FRAMELESSHELPER_HAS_XCB
+#include <QtGui/qpa/qplatformnativeinterface.h>
+#include <xcb/xcb.h>
+#include <cstdlib>
+#include <cstring>
+#endif
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 static constexpr int kDefaultResizeBorderThickness = 8;
 static constexpr int kDefaultCaptionHeight = 23;
 
+#ifdef FRAMELESSHELPER_HAS_XCB
+static constexpr char kGtkShowWindowMenu[] = "_GTK_SHOW_WINDOW_MENU";
+static constexpr char kNetSupported[] = "_NET_SUPPORTED";
+static constexpr char kNetWmMoveResize[] = "_NET_WM_MOVERESIZE";
+// The directions of _NET_WM_MOVERESIZE which let the user move or size the window
+// with the arrow keys, no mouse button has to be held.
+static constexpr uint32_t kNetWmMoveResizeSizeKeyboard = 9;
+static constexpr uint32_t kNetWmMoveResizeMoveKeyboard = 10;
+// The request comes from a normal application.
+static constexpr uint32_t kNetWmSourceApplication = 1;
+
+[[nodiscard]] static inline xcb_connection_t *getXcbConnection()
+{
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        return nullptr;
+    }
+    QPlatformNativeInterface *nativeInterface = QGuiApplication::platformNativeInterface();
+    if (!nativeInterface) {
+        return nullptr;
+    }
+    return static_cast<xcb_connection_t *>(nativeInterface->nativeResourceForIntegration(QByteArrayLiteral("connection")));
+}
+
+[[nodiscard]] static inline xcb_window_t getXcbRootWindow(xcb_connection_t *connection)
+{
+    Q_ASSERT(connection);
+    if (!connection) {
+        return XCB_NONE;
+    }
+    const xcb_setup_t *setup = xcb_get_setup(connection);
+    if (!setup) {
+        return XCB_NONE;
+    }
+    const xcb_screen_iterator_t it = xcb_setup_roots_iterator(setup);
+    return (it.data ? it.data->root : XCB_NONE);
+}
+
+[[nodiscard]] static inline xcb_atom_t internXcbAtom(xcb_connection_t *connection, const char *name)
+{
+    Q_ASSERT(connection);
+    Q_ASSERT(name);
+    if (!connection || !name) {
+        return XCB_NONE;
+    }
+    const xcb_intern_atom_cookie_t cookie = xcb_intern_atom(connection, true, static_cast<uint16_t>(qstrlen(name)), name);
+    xcb_intern_atom_reply_t *reply = xcb_intern_atom_reply(connection, cookie, nullptr);
+    if (!reply) {
+        return XCB_NONE;
+    }
+    const xcb_atom_t atom = reply->atom;
+    free(reply);
+    return atom;
+}
+
+// Whether the current window manager lists the given atom in _NET_SUPPORTED.
+[[nodiscard]] static inline bool isSupportedByWindowManager(xcb_connection_t *connection, const xcb_atom_t atom)
+{
+    Q_ASSERT(connection);
+    if (!connection || (atom == XCB_NONE)) {
+        return false;
+    }
+    const xcb_window_t root = getXcbRootWindow(connection);
+    const xcb_atom_t netSupported = internXcbAtom(connection, kNetSupported);
+    if ((root == XCB_NONE) || (netSupported == XCB_NONE)) {
+        return false;
+    }
+    const xcb_get_property_cookie_t cookie = xcb_get_property(connection, false, root, netSupported, XCB_ATOM_ATOM, 0, 4096);
+    xcb_get_property_reply_t *reply = xcb_get_property_reply(connection, cookie, nullptr);
+    if (!reply) {
+        return false;
+    }
+    bool result = false;
+    if ((reply->type == XCB_ATOM_ATOM) && (reply->format == 32)) {
+        const auto atoms = static_cast<const xcb_atom_t *>(xcb_get_property_value(reply));
+        const int count = (xcb_get_property_value_length(reply) / static_cast<int>(sizeof(xcb_atom_t)));
+        for (int i = 0; i != count; ++i) {
+            if (atoms[i] == atom) {
+                result = true;
+                break;
+            }
+        }
+    }
+    free(reply);
+    return result;
+}
+
+// Returns the _GTK_SHOW_WINDOW_MENU atom if the current window manager announces
+// support for it, XCB_NONE otherwise. The round trips are only done once.
+[[nodiscard]] static inline xcb_atom_t getGtkShowWindowMenuAtom(xcb_connection_t *connection)
+{
+    Q_ASSERT(connection);
+    if (!connection) {
+        return XCB_NONE;
+    }
+    static bool tried = false;
+    static xcb_atom_t result = XCB_NONE;
+    if (tried) {
+        return result;
+    }
+    tried = true;
+    const xcb_atom_t atom = internXcbAtom(connection, kGtkShowWindowMenu);
+    if (isSupportedByWindowManager(connection, atom)) {
+        result = atom;
+    }
+    return result;
+}
+
+// Same as above, for _NET_WM_MOVERESIZE.
+[[nodiscard]] static inline xcb_atom_t getNetWmMoveResizeAtom(xcb_connection_t *connection)
+{
+    Q_ASSERT(connection);
+    if (!connection) {
+        return XCB_NONE;
+    }
+    static bool tried = false;
+    static xcb_atom_t result = XCB_NONE;
+    if (tried) {
+        return result;
+    }
+    tried = true;
+    const xcb_atom_t atom = internXcbAtom(connection, kNetWmMoveResize);
+    if (isSupportedByWindowManager(connection, atom)) {
+        result = atom;
+    }
+    return result;
+}
+
+[[nodiscard]] static inline bool showGtkWindowMenu(const WId winId, const QPointF &pos)
+{
+    Q_ASSERT(winId);
+    if (!winId) {
+        return false;
+    }
+    xcb_connection_t *connection = getXcbConnection();
+    if (!connection) {
+        return false;
+    }
+    const xcb_atom_t atom = getGtkShowWindowMenuAtom(connection);
+    if (atom == XCB_NONE) {
+        return false;
+    }
+    const xcb_window_t root = getXcbRootWindow(connection);
+    if (root == XCB_NONE) {
+        return false;
+    }
+    xcb_client_message_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.response_type = XCB_CLIENT_MESSAGE;
+    event.format = 32;
+    event.window = static_cast<xcb_window_t>(winId);
+    event.type = atom;
+    event.data.data32[0] = 0; // Device ID, zero means the core pointer.
+    event.data.data32[1] = static_cast<uint32_t>(qRound(pos.x()));
+    event.data.data32[2] = static_cast<uint32_t>(qRound(pos.y()));
+    // The window manager can't grab the pointer if we are still holding it.
+    xcb_ungrab_pointer(connection, XCB_CURRENT_TIME);
+    xcb_send_event(connection, false, root,
+                   (XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT),
+                   reinterpret_cast<const char *>(&event));
+    xcb_flush(connection);
+    return true;
+}
+#endif
+
+
 int Utilities::getSystemMetric(const QWindow *window, const SystemMetric metric, const bool dpiScale, const bool forceSystemValue)
 {
     Q_ASSERT(window);
@@ -118,18 +292,127 @@ bool Utilities::isThemeChanged(const void *data)
 
 bool Utilities::isSystemMenuRequested(const void *data, QPointF *pos)
 {
-    // ### TO BE IMPLEMENTED
-    Q_UNUSED(data);
+    Q_ASSERT(data);
+    if (!data) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_HAS_XCB
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        return false;
+    }
+    const auto event = static_cast<const xcb_generic_event_t *>(data);
+    if ((event->response_type & ~0x80) != XCB_BUTTON_RELEASE) {
+        return false;
+    }
+    const auto buttonEvent = static_cast<const xcb_button_release_event_t *>(data);
+    if (buttonEvent->detail != XCB_BUTTON_INDEX_3) {
+        return false;
+    }
+    const QWindow *window = findWindow(static_cast<WId>(buttonEvent->event));
+    if (!window || !FramelessWindowsManager::isWindowFrameless(window)) {
+        return false;
+    }
+    // The event coordinates are in device pixels.
+    const QPointF localPos = (QPointF(static_cast<qreal>(buttonEvent->event_x),
+                                      static_cast<qreal>(buttonEvent->event_y)) / window->devicePixelRatio());
+    const int resizeBorderThickness = FramelessWindowsManager::getResizeBorderThickness(window);
+    if (!isInsideTitleBar(window, localPos, resizeBorderThickness) || isHitTestVisible(window, localPos)) {
+        return false;
+    }
+    if (pos) {
+        *pos = {static_cast<qreal>(buttonEvent->root_x), static_cast<qreal>(buttonEvent->root_y)};
+    }
+    return true;
+#else
     Q_UNUSED(pos);
     return false;
+#endif
 }
 
 bool Utilities::showSystemMenu(const WId winId, const QPointF &pos)
 {
-    // ### TO BE IMPLEMENTED
-    Q_UNUSED(winId);
-    Q_UNUSED(pos);
+    Q_ASSERT(winId);
+    if (!winId) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_HAS_XCB
+    // Let the window manager show its own menu if it can, it's native and
+    // doesn't cost us anything.
+    if (showGtkWindowMenu(winId, pos)) {
+        return true;
+    }
+#endif
+    // Fall back to our own menu, if the widgets module has provided one.
+    const SystemMenuProvider provider = getSystemMenuProvider();
+    if (!provider) {
+        // Once is enough, it's a setup mistake rather than a runtime failure.
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            qWarning() << "Failed to display the system menu: no usable implementation is available."
+                       << "Call FramelessHelperWidgets::initialize() or Utilities::setSystemMenuProvider() to provide one.";
+        }
+        return false;
+    }
+    QWindow *window = findWindow(winId);
+    if (!window) {
+        return false;
+    }
+    const qreal dpr = window->devicePixelRatio();
+    const QPoint globalPos = {qRound(pos.x() / dpr), qRound(pos.y() / dpr)};
+    return provider(window, globalPos);
+}
+
+bool Utilities::isKeyboardMoveResizeSupported()
+{
+#ifdef FRAMELESSHELPER_HAS_XCB
+    xcb_connection_t *connection = getXcbConnection();
+    return (connection && (getNetWmMoveResizeAtom(connection) != XCB_NONE));
+#else
+    return false;
+#endif
+}
+
+bool Utilities::startKeyboardMoveResize(const WId winId, const bool resize)
+{
+    Q_ASSERT(winId);
+    if (!winId) {
+        return false;
+    }
+#ifdef FRAMELESSHELPER_HAS_XCB
+    xcb_connection_t *connection = getXcbConnection();
+    if (!connection) {
+        return false;
+    }
+    const xcb_atom_t atom = getNetWmMoveResizeAtom(connection);
+    if (atom == XCB_NONE) {
+        return false;
+    }
+    const xcb_window_t root = getXcbRootWindow(connection);
+    if (root == XCB_NONE) {
+        return false;
+    }
+    xcb_client_message_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.response_type = XCB_CLIENT_MESSAGE;
+    event.format = 32;
+    event.window = static_cast<xcb_window_t>(winId);
+    event.type = atom;
+    // The pointer position and the button are not used by the keyboard modes.
+    event.data.data32[2] = (resize ? kNetWmMoveResizeSizeKeyboard : kNetWmMoveResizeMoveKeyboard);
+    event.data.data32[4] = kNetWmSourceApplication;
+    // The window manager grabs the keyboard and the pointer for the whole operation.
+    xcb_ungrab_pointer(connection, XCB_CURRENT_TIME);
+    xcb_ungrab_keyboard(connection, XCB_CURRENT_TIME);
+    xcb_send_event(connection, false, root,
+                   (XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT),
+                   reinterpret_cast<const char *>(&event));
+    xcb_flush(connection);
+    return true;
+#else
+    Q_UNUSED(resize);
     return false;
+#endif
 }
 
-FRAMELESSHELPER_END_NAMESPACE
\ No newline at end of file
+FRAMELESSHELPER_END_NAMESPACE
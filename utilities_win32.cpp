@@ -38,6 +38,8 @@
 #include <QtGui/qpa/qplatformwindow_p.h>
 #endif
 #include "framelesshelper_windows.h"
+#include "framelessstatistics.h"
+#include "framelesstracer.h"
 
 Q_DECLARE_METATYPE(QMargins)
 
@@ -230,6 +232,8 @@ void Utilities::triggerFrameChange(const WId winId)
     if (!winId) {
         return;
     }
+    FRAMELESSHELPER_STATISTICS_INCREMENT(nullptr, FrameChanges);
+    FRAMELESSHELPER_TRACE_SCOPE("triggerFrameChange");
     const auto hwnd = reinterpret_cast<HWND>(winId);
     constexpr UINT flags = (SWP_FRAMECHANGED | SWP_NOACTIVATE | SWP_NOSIZE | SWP_NOMOVE | SWP_NOZORDER | SWP_NOOWNERZORDER);
     if (SetWindowPos(hwnd, nullptr, 0, 0, 0, 0, flags) == FALSE) {
@@ -303,6 +307,7 @@ QString Utilities::getSystemErrorMessage(const QString &function)
 
 QColor Utilities::getColorizationColor()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("getColorizationColor");
     DWORD color = 0;
     BOOL opaque = FALSE;
     const HRESULT hr = DwmGetColorizationColor(&color, &opaque);
@@ -340,6 +345,7 @@ int Utilities::getWindowVisibleFrameBorderThickness(const WId winId)
 
 bool Utilities::shouldAppsUseDarkMode()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("shouldAppsUseDarkMode");
     if (!isWin10RS1OrGreater()) {
         return false;
     }
@@ -382,6 +388,7 @@ bool Utilities::shouldAppsUseDarkMode()
 
 ColorizationArea Utilities::getColorizationArea()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("getColorizationArea");
     if (!isWin10OrGreater()) {
         return ColorizationArea::None;
     }
@@ -509,4 +516,25 @@ bool Utilities::showSystemMenu(const WId winId, const QPointF &pos)
     return true;
 }
 
+bool Utilities::isKeyboardMoveResizeSupported()
+{
+    return true;
+}
+
+bool Utilities::startKeyboardMoveResize(const WId winId, const bool resize)
+{
+    Q_ASSERT(winId);
+    if (!winId) {
+        return false;
+    }
+    const auto hWnd = reinterpret_cast<HWND>(winId);
+    // Without the mouse position in lParam, the system enters the keyboard mode.
+    // Posted, the move/size loop must not run inside the caller.
+    if (PostMessageW(hWnd, WM_SYSCOMMAND, (resize ? SC_SIZE : SC_MOVE), 0) == FALSE) {
+        qWarning() << getSystemErrorMessage(QStringLiteral("PostMessageW"));
+        return false;
+    }
+    return true;
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,15 @@
+TARGET = $$qtLibraryTarget(FramelessHelperWidgets)
+include($$PWD/lib.pri)
+QT += widgets
+DEFINES += FRAMELESSHELPER_WIDGETS_BUILD_LIBRARY
+HEADERS += \
+    framelesshelperwidgets.h \
+    framelessstandardtitlebar.h \
+    framelessthemeapplier.h \
+    framelesswindowborderoverlay.h
+SOURCES += \
+    framelesshelperwidgets.cpp \
+    framelessstandardtitlebar.cpp \
+    framelessthemeapplier.cpp \
+    framelesswindowborderoverlay.cpp
+include($$PWD/core.pri)